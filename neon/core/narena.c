@@ -0,0 +1,41 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+/** @file
+ *  @defgroup   narena_impl Arena allocator implementation
+ *  @brief      Arena allocator implementation
+ *  @{ *//*==================================================================*/
+
+#include "core/narena.h"
+
+void narena_init(struct narena * arena, void * storage, size_t size)
+{
+    arena->storage = storage;
+    arena->size = size;
+    arena->used = 0u;
+}
+
+/* The padding is calculated from the address, so the storage itself does not
+ * need to be aligned. The padding and size are checked separately, so a size
+ * near SIZE_MAX can not wrap the sum around.
+ */
+void * narena_alloc(struct narena * arena, size_t size)
+{
+    uintptr_t address = (uintptr_t)&arena->storage[arena->used];
+    size_t padding = (size_t)((0u - address) & (NARENA_ALIGN - 1u));
+    size_t remaining = arena->size - arena->used;
+    void * mem;
+
+    if ((padding > remaining) || (size > (remaining - padding))) {
+        return NULL;
+    }
+    mem = &arena->storage[arena->used + padding];
+    arena->used += padding + size;
+
+    return mem;
+}
+
+/** @} */
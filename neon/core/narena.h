@@ -0,0 +1,148 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+/** @file
+ *  @addtogroup neon
+ *  @{
+ */
+/** @defgroup   narena Arena allocator
+ *  @brief      Arena allocator
+ *
+ *  The arena hands out memory by advancing an offset in its storage, so an
+ *  allocation takes constant time and freeing is done in bulk: everything
+ *  allocated after a mark is released by resetting the arena to the mark.
+ *  Individual allocations are never freed.
+ *
+ *  An EPA may have its own arena which is reset after each dispatched event,
+ *  see @ref NEPA_ARENA_INIT.
+ *  @{
+ */
+
+#ifndef NEON_ARENA_H_
+#define NEON_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief      Types with the strictest alignment requirement.
+ *  @notapi
+ */
+union narena_align
+{
+    long long                   ll;
+    double                      d;
+    void *                      p;
+};
+
+/** @brief      Alignment of arena allocations in bytes.
+ */
+#define NARENA_ALIGN                    sizeof(union narena_align)
+
+/** @brief      Arena base structure.
+ *  @notapi
+ */
+struct narena
+{
+    uint8_t * storage;
+    size_t size;
+    size_t used;
+};
+
+/** @brief      Arena custom structure.
+ *
+ *  Contains the Base structure and the storage of @a size bytes.
+ *
+ *  @code
+ *  struct scratch_arena narena(512);
+ *  @endcode
+ *
+ *  @param      size
+ *              Size of arena storage in bytes.
+ */
+#define narena(size)                                                        \
+    {                                                                       \
+        struct narena super;                                                \
+        uint8_t np_arena_storage[size];                                     \
+    }
+
+/** @brief      Initialize an arena.
+ *  @param      A
+ *              Pointer to arena defined by @ref narena.
+ *  @mseffect
+ */
+#define NARENA_INIT(A)                                                      \
+        narena_init(                                                        \
+                &(A)->super,                                                \
+                &(A)->np_arena_storage[0],                                  \
+                sizeof((A)->np_arena_storage))
+
+/** @brief      Return the arena base structure.
+ *  @param      A
+ *              Pointer to arena defined by @ref narena.
+ */
+#define NARENA(A)                       (&(A)->super)
+
+/** @brief      Initialise the arena base.
+ *  @param      arena
+ *              Pointer to arena base.
+ *  @param      storage
+ *              Pointer to arena storage.
+ *  @param      size
+ *              Size of arena storage in bytes.
+ */
+void narena_init(struct narena * arena, void * storage, size_t size);
+
+/** @brief      Allocate memory from the arena.
+ *  @param      arena
+ *              Pointer to arena base.
+ *  @param      size
+ *              Size of memory in bytes.
+ *  @return     Pointer to memory aligned to @ref NARENA_ALIGN bytes, or NULL
+ *              when the arena has not enough free space.
+ */
+void * narena_alloc(struct narena * arena, size_t size);
+
+/** @brief      Mark the current arena state.
+ *  @param      arena
+ *              Pointer to arena base.
+ *  @return     A mark which is given to @ref narena_reset.
+ */
+static inline
+size_t narena_mark(const struct narena * arena)
+{
+    return arena->used;
+}
+
+/** @brief      Release all memory allocated after the mark was taken.
+ *  @param      arena
+ *              Pointer to arena base.
+ *  @param      mark
+ *              A mark returned by @ref narena_mark, or zero to release all
+ *              allocated memory.
+ */
+static inline
+void narena_reset(struct narena * arena, size_t mark)
+{
+    arena->used = mark;
+}
+
+/** @brief      Returns the number of bytes used in arena, including
+ *              alignment padding.
+ */
+#define NARENA_USED(A)                  ((A)->super.used)
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+/** @} */
+
+#endif /* NEON_ARENA_H_ */
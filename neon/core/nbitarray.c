@@ -26,12 +26,12 @@ static uint_fast8_t calculate_bit_position(uint_fast8_t bit)
     return bit & (NARCH_DATA_WIDTH - 1u); /* bit % NARCH_DATA_WIDTH */
 }
 
-void np_bitarray_init(uint32_t * array, uint8_t size_bytes)
+void nbitarray_init(uint32_t * array, uint8_t size_bytes)
 {
     memset(array, 0, size_bytes);
 }
 
-void np_bitarray_set(uint32_t * array, uint_fast8_t bit)
+void nbitarray_set(uint32_t * array, uint_fast8_t bit)
 {
     uint_fast8_t group;
     uint_fast8_t position;
@@ -43,7 +43,7 @@ void np_bitarray_set(uint32_t * array, uint_fast8_t bit)
     array[0] |= narch_exp2(group);
 }
 
-void np_bitarray_clear(uint32_t * array, uint_fast8_t bit)
+void nbitarray_clear(uint32_t * array, uint_fast8_t bit)
 {
     uint_fast8_t group;
     uint_fast8_t position;
@@ -58,7 +58,7 @@ void np_bitarray_clear(uint32_t * array, uint_fast8_t bit)
     }
 }
 
-uint_fast8_t np_bitarray_msbs(const uint32_t * array)
+uint_fast8_t nbitarray_msbs(const uint32_t * array)
 {
     uint_fast8_t group;
     uint_fast8_t pos;
@@ -69,7 +69,41 @@ uint_fast8_t np_bitarray_msbs(const uint32_t * array)
     return (uint_fast8_t)(group * (uint_fast8_t)NARCH_DATA_WIDTH + pos);
 }
 
-bool np_bitarray_is_set(const uint32_t * array, uint_fast8_t bit)
+/* The lowest set bit of a word is isolated with two's complement, so the
+ * search needs only narch_log2.
+ */
+static uint_fast8_t calculate_lsbs(uint32_t word)
+{
+    return narch_log2(word & (~word + 1u));
+}
+
+uint_fast8_t nbitarray_lsbs_above(const uint32_t * array, uint_fast8_t bit)
+{
+    uint_fast8_t group;
+    uint_fast8_t position;
+    uint32_t word;
+    uint32_t groups;
+
+    group = calculate_bit_group(bit);
+    position = calculate_bit_position(bit);
+    word = array[group + 1] & ((uint32_t)0xfffffffeu << position);
+
+    if (word != 0u) {
+        return (uint_fast8_t)(group * (uint_fast8_t)NARCH_DATA_WIDTH +
+                calculate_lsbs(word));
+    }
+    groups = array[0] & ((uint32_t)0xfffffffeu << group);
+
+    if (groups == 0u) {
+        return bit;
+    }
+    group = calculate_lsbs(groups);
+
+    return (uint_fast8_t)(group * (uint_fast8_t)NARCH_DATA_WIDTH +
+            calculate_lsbs(array[group + 1]));
+}
+
+bool nbitarray_is_set(const uint32_t * array, uint_fast8_t bit)
 {
     uint_fast8_t group;
     uint_fast8_t position;
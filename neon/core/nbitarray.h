@@ -34,7 +34,7 @@ struct nbitarray
 };
 
 #define NBITARRAY_SIZE(a_bits)											\
-			(1u + NBITS_DIVIDE_ROUNDUP((a_size), NARCH_DATA_WIDTH))
+			(1u + NBITS_DIVIDE_ROUNDUP((a_bits), NARCH_DATA_WIDTH))
 
 #define nbitarray_elements(a_bits)	\
 		uint32_t elements[NBITARRAY_SIZE(a_bits)]
@@ -50,7 +50,68 @@ struct nbitarray
 			uint32_t elements[(1u + NBITS_DIVIDE_ROUNDUP((a_size), NARCH_DATA_WIDTH))]; \
 		}
 
+/** @brief      Initialize a bit array structure.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ */
+#define NBITARRAY_INIT(A)                                                   \
+        nbitarray_init(&(A)->elements[0], sizeof((A)->elements))
+
+/** @brief      Set a bit in the bit array.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ *  @param      a_bit
+ *              Bit to set.
+ */
+#define NBITARRAY_SET(A, a_bit)                                             \
+        nbitarray_set(&(A)->elements[0], (a_bit))
+
+/** @brief      Clear a bit in the bit array.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ *  @param      a_bit
+ *              Bit to clear.
+ */
+#define NBITARRAY_CLEAR(A, a_bit)                                           \
+        nbitarray_clear(&(A)->elements[0], (a_bit))
+
+/** @brief      Get the most significant set bit in the bit array.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ *  @note       Before calling this macro ensure that the array is not empty,
+ *              see @ref NBITARRAY_IS_EMPTY.
+ */
+#define NBITARRAY_MSBS(A)                                                   \
+        nbitarray_msbs(&(A)->elements[0])
+
+/** @brief      Get the least significant set bit above @a a_bit in the bit
+ *              array.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ *  @param      a_bit
+ *              Bit above which the search starts.
+ *  @return     The found bit, or @a a_bit when no bit above it is set.
+ */
+#define NBITARRAY_LSBS_ABOVE(A, a_bit)                                      \
+        nbitarray_lsbs_above(&(A)->elements[0], (a_bit))
+
+/** @brief      Return true if a bit is set in the bit array.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ *  @param      a_bit
+ *              Bit to test.
+ */
+#define NBITARRAY_IS_SET(A, a_bit)                                          \
+        nbitarray_is_set(&(A)->elements[0], (a_bit))
+
+/** @brief      Return true if no bit is set in the bit array.
+ *  @param      A
+ *              Pointer to bit array defined by @ref nbitarray.
+ */
+#define NBITARRAY_IS_EMPTY(A)           ((A)->elements[0] == 0u)
+
 /** @brief      Initialize the array.
+ *  @notapi
  */
 void nbitarray_init(nbitarray * array, uint8_t size_bytes);
 
@@ -69,6 +130,11 @@ void nbitarray_clear(uint32_t * array, uint_fast8_t bit);
  */
 uint_fast8_t nbitarray_msbs(const uint32_t * array);
 
+/** @brief      Get the first set bit above the given bit.
+ *  @notapi
+ */
+uint_fast8_t nbitarray_lsbs_above(const uint32_t * array, uint_fast8_t bit);
+
 /** @brief      Evaluates if a specified bit is set in the array.
  *  @notapi
  */
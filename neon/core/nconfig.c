@@ -73,6 +73,136 @@ const struct nconfig_entry * nconfig_record_fetch(enum nconfig_entry_id idx)
 			"NCONFIG_USE_EXCLUSIVE_ACCESS",
 			NCONFIG_USE_EXCLUSIVE_ACCESS
         },
+        [NCONFIG_ENTRY_SCHEDULER_USE_MULTICORE] =
+        {
+			"NCONFIG_SCHEDULER_USE_MULTICORE",
+			NCONFIG_SCHEDULER_USE_MULTICORE
+        },
+        [NCONFIG_ENTRY_SCHEDULER_INBOUND_SIZE] =
+        {
+			"NCONFIG_SCHEDULER_INBOUND_SIZE",
+			NCONFIG_SCHEDULER_INBOUND_SIZE
+        },
+        [NCONFIG_ENTRY_SCHEDULER_USE_WORK_STEALING] =
+        {
+			"NCONFIG_SCHEDULER_USE_WORK_STEALING",
+			NCONFIG_SCHEDULER_USE_WORK_STEALING
+        },
+        [NCONFIG_ENTRY_SCHEDULER_POOL_WORKERS] =
+        {
+			"NCONFIG_SCHEDULER_POOL_WORKERS",
+			NCONFIG_SCHEDULER_POOL_WORKERS
+        },
+        [NCONFIG_ENTRY_EPA_EVENT_BUDGET] =
+        {
+			"NCONFIG_EPA_EVENT_BUDGET",
+			NCONFIG_EPA_EVENT_BUDGET
+        },
+        [NCONFIG_ENTRY_TIMER_WHEEL_LEVELS] =
+        {
+			"NCONFIG_TIMER_WHEEL_LEVELS",
+			NCONFIG_TIMER_WHEEL_LEVELS
+        },
+        [NCONFIG_ENTRY_TIMER_WHEEL_SLOT_BITS] =
+        {
+			"NCONFIG_TIMER_WHEEL_SLOT_BITS",
+			NCONFIG_TIMER_WHEEL_SLOT_BITS
+        },
+        [NCONFIG_ENTRY_SYS_USE_TICKLESS_IDLE] =
+        {
+			"NCONFIG_SYS_USE_TICKLESS_IDLE",
+			NCONFIG_SYS_USE_TICKLESS_IDLE
+        },
+        [NCONFIG_ENTRY_SYS_TICK_US] =
+        {
+			"NCONFIG_SYS_TICK_US",
+			NCONFIG_SYS_TICK_US
+        },
+        [NCONFIG_ENTRY_SCHEDULER_USE_PREEMPTION] =
+        {
+			"NCONFIG_SCHEDULER_USE_PREEMPTION",
+			NCONFIG_SCHEDULER_USE_PREEMPTION
+        },
+        [NCONFIG_ENTRY_EPA_USE_PUBSUB] =
+        {
+			"NCONFIG_EPA_USE_PUBSUB",
+			NCONFIG_EPA_USE_PUBSUB
+        },
+        [NCONFIG_ENTRY_EPA_PUBSUB_SIGNALS] =
+        {
+			"NCONFIG_EPA_PUBSUB_SIGNALS",
+			NCONFIG_EPA_PUBSUB_SIGNALS
+        },
+        [NCONFIG_ENTRY_EPA_USE_DEFER] =
+        {
+			"NCONFIG_EPA_USE_DEFER",
+			NCONFIG_EPA_USE_DEFER
+        },
+        [NCONFIG_ENTRY_EPA_USE_MPSC_QUEUE] =
+        {
+			"NCONFIG_EPA_USE_MPSC_QUEUE",
+			NCONFIG_EPA_USE_MPSC_QUEUE
+        },
+        [NCONFIG_ENTRY_LQUEUE_USE_LARGE] =
+        {
+			"NCONFIG_LQUEUE_USE_LARGE",
+			NCONFIG_LQUEUE_USE_LARGE
+        },
+        [NCONFIG_ENTRY_LQUEUE_USE_WAIT] =
+        {
+			"NCONFIG_LQUEUE_USE_WAIT",
+			NCONFIG_LQUEUE_USE_WAIT
+        },
+        [NCONFIG_ENTRY_EPA_USE_URGENT_LANE] =
+        {
+			"NCONFIG_EPA_USE_URGENT_LANE",
+			NCONFIG_EPA_USE_URGENT_LANE
+        },
+        [NCONFIG_ENTRY_PQUEUE_PRIORITIES] =
+        {
+			"NCONFIG_PQUEUE_PRIORITIES",
+			NCONFIG_PQUEUE_PRIORITIES
+        },
+        [NCONFIG_ENTRY_MEMPOOL_USE_LOCK_FREE] =
+        {
+			"NCONFIG_MEMPOOL_USE_LOCK_FREE",
+			NCONFIG_MEMPOOL_USE_LOCK_FREE
+        },
+        [NCONFIG_ENTRY_MEMPOOL_USE_CACHE] =
+        {
+			"NCONFIG_MEMPOOL_USE_CACHE",
+			NCONFIG_MEMPOOL_USE_CACHE
+        },
+        [NCONFIG_ENTRY_MEMPOOL_CACHE_SIZE] =
+        {
+			"NCONFIG_MEMPOOL_CACHE_SIZE",
+			NCONFIG_MEMPOOL_CACHE_SIZE
+        },
+        [NCONFIG_ENTRY_EVENT_USE_HEAP] =
+        {
+			"NCONFIG_EVENT_USE_HEAP",
+			NCONFIG_EVENT_USE_HEAP
+        },
+        [NCONFIG_ENTRY_MEMPOOL_USE_LAZY_INIT] =
+        {
+			"NCONFIG_MEMPOOL_USE_LAZY_INIT",
+			NCONFIG_MEMPOOL_USE_LAZY_INIT
+        },
+        [NCONFIG_ENTRY_MEMPOOL_ALIGN] =
+        {
+			"NCONFIG_MEMPOOL_ALIGN",
+			NCONFIG_MEMPOOL_ALIGN
+        },
+        [NCONFIG_ENTRY_MEMPOOL_USE_MAPPED] =
+        {
+			"NCONFIG_MEMPOOL_USE_MAPPED",
+			NCONFIG_MEMPOOL_USE_MAPPED
+        },
+        [NCONFIG_ENTRY_EPA_USE_ARENA] =
+        {
+			"NCONFIG_EPA_USE_ARENA",
+			NCONFIG_EPA_USE_ARENA
+        },
     };
 
     if (idx >= NBITS_ARRAY_SIZE(record)) {
@@ -195,6 +195,107 @@ extern "C" {
 #define NCONFIG_EPA_HSM_LEVELS          8
 #endif
 
+/** @brief      Enable or disable publish/subscribe event delivery.
+ * 
+ *  When enabled, EPAs can subscribe to signals and an event can be published
+ *  to all subscribers at once, see @ref nepa_publish.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (publish/subscribe is not enabled).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_USE_PUBSUB)
+#define NCONFIG_EPA_USE_PUBSUB          0
+#endif
+
+/** @brief      Configure the number of signals which can be published.
+ * 
+ *  Only events with identifier smaller than this value can be published.
+ *  Each signal uses a bit array of @ref NCONFIG_SCHEDULER_PRIORITIES bits
+ *  and each EPA uses a bit array of this many bits. The maximum value is 256.
+ * 
+ *  Default value is 32 (signals 0 - 31).
+ * 
+ *  @note       This configuration option is ignored when
+ *              @ref NCONFIG_EPA_USE_PUBSUB is not enabled.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_PUBSUB_SIGNALS)
+#define NCONFIG_EPA_PUBSUB_SIGNALS      32
+#endif
+
+#if (NCONFIG_EPA_PUBSUB_SIGNALS > 256)
+#error "Publish subscribe supports at most 256 signals."
+#endif
+
+/** @brief      Enable or disable deferred events.
+ * 
+ *  When enabled, each EPA has an optional defer queue. An EPA can park an
+ *  event which it can not handle in its current state and recall it later,
+ *  see @ref nepa_defer and @ref nepa_recall.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (deferred events are not enabled).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_USE_DEFER)
+#define NCONFIG_EPA_USE_DEFER           0
+#endif
+
+/** @brief      Enable or disable urgent event lanes.
+ * 
+ *  When enabled, each EPA has an optional urgent lane next to its event
+ *  queue. Events sent with @ref nepa_send_event_urgent are dispatched in FIFO
+ *  order before any event waiting in the event queue.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (urgent lanes are not enabled).
+ * 
+ *  @note       This option can not be used together with
+ *              @ref NCONFIG_EPA_USE_MPSC_QUEUE.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_USE_URGENT_LANE)
+#define NCONFIG_EPA_USE_URGENT_LANE     0
+#endif
+
+/** @brief      Configure the maximum number of events dispatched per EPA
+ *              activation.
+ * 
+ *  When the scheduler activates an EPA, the EPA claims up to this number of
+ *  events from its queue in a single critical section and then dispatches
+ *  them one after another. Bigger values lower the scheduling overhead per
+ *  event, but a higher priority EPA may wait for the whole batch to finish.
+ * 
+ *  This value is the default budget of each EPA and it is also the upper
+ *  limit for per EPA budget, see @ref NEPA_INITIALIZER_BUDGET. Valid values
+ *  are 1 - 255.
+ * 
+ *  Default value is 1 (one event per activation).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_EVENT_BUDGET)
+#define NCONFIG_EPA_EVENT_BUDGET        1
+#endif
+
+#if (NCONFIG_EPA_EVENT_BUDGET < 1) || (NCONFIG_EPA_EVENT_BUDGET > 255)
+#error "EPA event budget must be in range 1 - 255."
+#endif
+
 /** @brief      Configure if loop scheduler should be exitable.
  * 
  *  Normally, in an embedded applications once a loop scheduler is started it is
@@ -211,6 +312,42 @@ extern "C" {
 #if !defined(NCONFIG_SYS_EXITABLE_SCHEDULER)
 #define NCONFIG_SYS_EXITABLE_SCHEDULER  0
 #endif
+
+/** @brief      Configure tickless idle.
+ * 
+ *  When enabled, the idle EPA services the system timing wheel
+ *  @ref nsys_timer_wheel and then puts the scheduler thread to sleep until
+ *  the next timer deadline or until an event is sent to an EPA. There is no
+ *  periodic tick which would wake up the system.
+ * 
+ *  The scheduler catches up the system timing wheel before each task is
+ *  executed, so the timers expire also when the scheduler is never idle.
+ *  Arming a timer from any thread wakes up the sleeping scheduler.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (tickless idle is not enabled).
+ * 
+ *  @note       This option requires OS support, see @ref nport_os, and it is
+ *              ignored when @ref NCONFIG_SCHEDULER_USE_MULTICORE is enabled.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SYS_USE_TICKLESS_IDLE)
+#define NCONFIG_SYS_USE_TICKLESS_IDLE   0
+#endif
+
+/** @brief      Configure the duration of system tick in microseconds.
+ * 
+ *  Default value is 1000 (1 ms tick).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SYS_TICK_US)
+#define NCONFIG_SYS_TICK_US             1000
+#endif
     
 /** @brief      Enable or disable dynamic event.
  * 
@@ -242,6 +379,404 @@ extern "C" {
 #define NCONFIG_USE_EXCLUSIVE_ACCESS    0
 #endif
 
+/** @brief      Enable or disable multi-core scheduling.
+ * 
+ *  When enabled, the application may run several scheduler instances, each
+ *  one in its own thread. An EPA belongs to the scheduler which registered it.
+ *  Events which are sent to an EPA owned by other scheduler are put into that
+ *  scheduler inbound queue and the owning thread is woken up. The ready queue
+ *  and EPA queues are accessed only by the owning thread, so no global
+ *  critical section is used by the scheduler.
+ * 
+ *  When this option is enabled the idle EPA is not used, instead the scheduler
+ *  thread sleeps when there are no ready tasks.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (multi-core scheduling is not enabled).
+ * 
+ *  @note       This option requires OS support, see @ref nport_os.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SCHEDULER_USE_MULTICORE)
+#define NCONFIG_SCHEDULER_USE_MULTICORE 0
+#endif
+
+/** @brief      Configure the size of scheduler inbound queue.
+ * 
+ *  The inbound queue holds events which are sent from other threads and are
+ *  not yet delivered to EPA queues. The value must be a power of 2.
+ * 
+ *  Default value is 64 (64 pending events).
+ * 
+ *  @note       This configuration option is ignored when
+ *              @ref NCONFIG_SCHEDULER_USE_MULTICORE is not enabled.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SCHEDULER_INBOUND_SIZE)
+#define NCONFIG_SCHEDULER_INBOUND_SIZE  64
+#endif
+
+/** @brief      Enable or disable work-stealing EPA dispatch pool.
+ * 
+ *  The pool is executed by several worker threads. Each worker has its own
+ *  queue of ready EPAs and a worker which has no ready EPAs steals ready EPAs
+ *  from other workers. An EPA is in at most one queue at any time, so it is
+ *  never executed by two workers at the same time. EPA priorities are not
+ *  used by the pool.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (work-stealing pool is not enabled).
+ * 
+ *  @note       This option requires OS support, see @ref nport_os.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SCHEDULER_USE_WORK_STEALING)
+#define NCONFIG_SCHEDULER_USE_WORK_STEALING 0
+#endif
+
+/** @brief      Configure the number of work-stealing pool workers.
+ * 
+ *  Default value is 4 (4 worker threads).
+ * 
+ *  @note       This configuration option is ignored when
+ *              @ref NCONFIG_SCHEDULER_USE_WORK_STEALING is not enabled.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SCHEDULER_POOL_WORKERS)
+#define NCONFIG_SCHEDULER_POOL_WORKERS  4
+#endif
+
+/** @brief      Configure the size of work-stealing pool worker queue.
+ * 
+ *  The value must be a power of 2 and it must not be smaller than the number
+ *  of EPAs registered with the pool.
+ * 
+ *  Default value is 32 (up to 32 EPAs per pool).
+ * 
+ *  @note       This configuration option is ignored when
+ *              @ref NCONFIG_SCHEDULER_USE_WORK_STEALING is not enabled.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SCHEDULER_POOL_QUEUE_SIZE)
+#define NCONFIG_SCHEDULER_POOL_QUEUE_SIZE 32
+#endif
+
+/** @brief      Enable or disable preemptive scheduling.
+ * 
+ *  When enabled, the scheduler works in a single stack preemptive mode based
+ *  on stack resource policy. Sending an event to an EPA with priority higher
+ *  than the current priority ceiling runs that EPA immediately, on the stack
+ *  of the sender. The ceiling is the priority of the currently executed EPA
+ *  and it can be temporarily raised to protect shared resources, see
+ *  @ref nscheduler_ceiling_raise.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (run to completion cooperative scheduling).
+ * 
+ *  @note       This option can not be used together with
+ *              @ref NCONFIG_SCHEDULER_USE_MULTICORE.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_SCHEDULER_USE_PREEMPTION)
+#define NCONFIG_SCHEDULER_USE_PREEMPTION 0
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1) && \
+    (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+#error "Preemptive scheduling is not supported in multi-core mode."
+#endif
+
+/** @brief      Enable or disable lock-free multi-producer EPA event queues.
+ * 
+ *  When enabled, the EPA event queues are bounded multi-producer/single-
+ *  consumer queues, see @ref nlqueue_mpsc_dynamic. Senders put events into
+ *  the queue without entering a critical section. The critical section is
+ *  entered only by the sender which makes the EPA ready.
+ * 
+ *  With @ref NCONFIG_SCHEDULER_USE_PREEMPTION an interrupt may preempt a
+ *  sender which has not finished its put. When a preempting EPA finds its
+ *  oldest event not yet put, the scheduler returns to the interrupted sender
+ *  and the EPA runs once the sender's priority allows it.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (event queues are protected by critical section).
+ * 
+ *  @note       This option can not be used together with
+ *              @ref NCONFIG_SCHEDULER_USE_MULTICORE or
+ *              @ref NCONFIG_SCHEDULER_USE_WORK_STEALING.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_USE_MPSC_QUEUE)
+#define NCONFIG_EPA_USE_MPSC_QUEUE      0
+#endif
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1) && \
+    ((NCONFIG_SCHEDULER_USE_MULTICORE == 1) || \
+     (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1))
+#error "Multi-producer event queues are not supported in multi-core mode."
+#endif
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1) && (NCONFIG_EPA_USE_URGENT_LANE == 1)
+#error "Urgent lanes are not supported with multi-producer event queues."
+#endif
+
+/** @brief      Enable or disable large lightweight queues.
+ * 
+ *  When enabled, the lightweight queue indices are 32-bit free running
+ *  counters and the queue size is limited only by available memory. The
+ *  number of items in queue is calculated as difference of tail and head
+ *  counters. When disabled, the indices are of platform fast 16-bit type
+ *  which is more efficient on 8-bit and 16-bit targets.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (queues with 16-bit indices).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_LQUEUE_USE_LARGE)
+#define NCONFIG_LQUEUE_USE_LARGE        0
+#endif
+
+/** @brief      Enable or disable waitable lightweight queues.
+ * 
+ *  When enabled, the @ref nlqueue_wait_dynamic queues are available. Threads
+ *  which are not EPAs block on these queues instead of polling them. The
+ *  option requires an OS port which implements @ref nos_word_wait and
+ *  @ref nos_word_wake, like the Linux port.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (waitable queues are not available).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_LQUEUE_USE_WAIT)
+#define NCONFIG_LQUEUE_USE_WAIT         0
+#endif
+
+/** @brief      Configure the number of priority sorted queue priorities.
+ * 
+ *  Each priority sorted queue sentinel holds a bit array of this number of
+ *  bits and a pointer for each priority level, so a sentinel takes roughly
+ *  one pointer of memory per priority level. Node priorities must be smaller
+ *  than this value. The maximum value is 256.
+ * 
+ *  Default value is 32 (priorities 0 - 31).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_PQUEUE_PRIORITIES)
+#define NCONFIG_PQUEUE_PRIORITIES       32
+#endif
+
+#if (NCONFIG_PQUEUE_PRIORITIES > 256)
+#error "Priority sorted queue supports at most 256 priorities."
+#endif
+
+/** @brief      Enable or disable lock-free memory pools.
+ * 
+ *  When enabled, @ref nmem_pool_alloc and @ref nmem_pool_free do not lock the
+ *  critical section. The free list head is an element index combined with a
+ *  generation counter which is updated with compare and swap, so a pool may
+ *  have at most 65535 elements. @ref nmem_pool_init uses only the first 65535
+ *  elements of a larger pool. The elements must be aligned for 32-bit
+ *  access.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (pools lock the critical section).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_MEMPOOL_USE_LOCK_FREE)
+#define NCONFIG_MEMPOOL_USE_LOCK_FREE   0
+#endif
+
+/** @brief      Enable or disable lazy memory pool initialization.
+ * 
+ *  When enabled, @ref nmem_pool_init does not touch the pool storage. Blocks
+ *  which were never allocated are handed out by a bump index when the free
+ *  list is empty, and only freed blocks are put into the free list. The pool
+ *  initialization takes constant time and the storage memory is touched only
+ *  as far as the pool was ever used. When @ref NCONFIG_MEMPOOL_USE_LOCK_FREE
+ *  is enabled, the bump index hands out at most 65535 blocks of a pool.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (all blocks are put into the free list on init).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_MEMPOOL_USE_LAZY_INIT)
+#define NCONFIG_MEMPOOL_USE_LAZY_INIT   0
+#endif
+
+/** @brief      Configure the alignment of aligned memory pool elements.
+ * 
+ *  Each element of a pool declared with @ref npool_aligned, and of a pool
+ *  initialized with @ref nmem_pool_init_mapped, starts at the multiple of this
+ *  value and no two elements share an aligned block. The value must be a
+ *  power of two.
+ * 
+ *  Default value is 0 (the size of CPU data cache line, see
+ *  @ref NARCH_CACHE_LINE).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_MEMPOOL_ALIGN)
+#define NCONFIG_MEMPOOL_ALIGN           0
+#endif
+
+/** @brief      Enable or disable memory pools with mapped storage.
+ * 
+ *  When enabled, @ref nmem_pool_init_mapped allocates the pool storage from
+ *  the OS, optionally backed by huge pages and locked in RAM. The option
+ *  requires an OS port which implements @ref nos_mem_map, like the Linux
+ *  port.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (mapped storage is not available).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_MEMPOOL_USE_MAPPED)
+#define NCONFIG_MEMPOOL_USE_MAPPED      0
+#endif
+
+/** @brief      Enable or disable per-thread memory pool caches.
+ * 
+ *  When enabled, a thread may attach a @ref nmem_cache to a pool. Blocks are
+ *  then allocated from and freed to the cache, and moved between the cache and
+ *  the pool in batches of half the cache size.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (caches are not available).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_MEMPOOL_USE_CACHE)
+#define NCONFIG_MEMPOOL_USE_CACHE       0
+#endif
+
+/** @brief      Configure the number of blocks in a memory pool cache.
+ * 
+ *  The value must be an even number.
+ * 
+ *  Default value is 16 (16 blocks, moved to and from the pool 8 at once).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_MEMPOOL_CACHE_SIZE)
+#define NCONFIG_MEMPOOL_CACHE_SIZE      16
+#endif
+
+/** @brief      Enable or disable the dynamic event heap.
+ * 
+ *  When enabled, @ref nevent_create takes the size of the event instead of a
+ *  memory pool. The event is allocated from the smallest registered pool of
+ *  the size class of the event, see @ref nevent_heap_register. Size classes
+ *  are powers of two, so pools with power of two element sizes waste no
+ *  memory.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (events are allocated from the given pool).
+ * 
+ *  @note       This option requires @ref NCONFIG_EVENT_USE_DYNAMIC.
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EVENT_USE_HEAP)
+#define NCONFIG_EVENT_USE_HEAP          0
+#endif
+
+#if (NCONFIG_EVENT_USE_HEAP == 1) && (NCONFIG_EVENT_USE_DYNAMIC == 0)
+#error "Event heap requires dynamic events."
+#endif
+
+/** @brief      Enable or disable per-dispatch EPA arenas.
+ * 
+ *  When enabled, an EPA may be given an arena, see @ref NEPA_ARENA_INIT. The
+ *  state handlers allocate temporary buffers from the arena and the arena is
+ *  reset after each dispatched event, so these buffers are never freed
+ *  explicitly.
+ * 
+ *  When this macro is set to '1' the option is enabled, when the macro is set
+ *  to '0' the option is disabled. Using any other value is undefined
+ *  behaviour.
+ * 
+ *  Default value is 0 (EPAs have no arena).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_EPA_USE_ARENA)
+#define NCONFIG_EPA_USE_ARENA           0
+#endif
+
+/** @brief      Configure the number of timing wheel levels.
+ * 
+ *  Each level of the hierarchical timing wheel covers the range of timeouts
+ *  which is @ref NCONFIG_TIMER_WHEEL_SLOT_BITS bits wider than the range of
+ *  previous level. The product of levels and slot bits must be smaller than
+ *  32.
+ * 
+ *  Default value is 4 (4 levels).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_TIMER_WHEEL_LEVELS)
+#define NCONFIG_TIMER_WHEEL_LEVELS      4
+#endif
+
+/** @brief      Configure the number of slots per timing wheel level.
+ * 
+ *  Each timing wheel level has 2^NCONFIG_TIMER_WHEEL_SLOT_BITS slots.
+ * 
+ *  Default value is 6 (64 slots per level, the longest timeout is 2^24 - 1
+ *  ticks with 4 levels).
+ * 
+ *  @hideinitializer
+ */
+#if !defined(NCONFIG_TIMER_WHEEL_SLOT_BITS)
+#define NCONFIG_TIMER_WHEEL_SLOT_BITS   6
+#endif
+
 enum nconfig_entry_id
 {
     NCONFIG_ENTRY_ENABLE_DEBUG,
@@ -254,7 +789,33 @@ enum nconfig_entry_id
     NCONFIG_ENTRY_SYS_EXITABLE_SCHEDULER,
     NCONFIG_ENTRY_EVENT_USE_DYNAMIC,
     NCONFIG_ENTRY_SCHEDULER_PRIORITIES,
-    NCONFIG_ENTRY_USE_EXCLUSIVE_ACCESS
+    NCONFIG_ENTRY_USE_EXCLUSIVE_ACCESS,
+    NCONFIG_ENTRY_SCHEDULER_USE_MULTICORE,
+    NCONFIG_ENTRY_SCHEDULER_INBOUND_SIZE,
+    NCONFIG_ENTRY_SCHEDULER_USE_WORK_STEALING,
+    NCONFIG_ENTRY_SCHEDULER_POOL_WORKERS,
+    NCONFIG_ENTRY_EPA_EVENT_BUDGET,
+    NCONFIG_ENTRY_TIMER_WHEEL_LEVELS,
+    NCONFIG_ENTRY_TIMER_WHEEL_SLOT_BITS,
+    NCONFIG_ENTRY_SYS_USE_TICKLESS_IDLE,
+    NCONFIG_ENTRY_SYS_TICK_US,
+    NCONFIG_ENTRY_SCHEDULER_USE_PREEMPTION,
+    NCONFIG_ENTRY_EPA_USE_PUBSUB,
+    NCONFIG_ENTRY_EPA_PUBSUB_SIGNALS,
+    NCONFIG_ENTRY_EPA_USE_DEFER,
+    NCONFIG_ENTRY_EPA_USE_MPSC_QUEUE,
+    NCONFIG_ENTRY_LQUEUE_USE_LARGE,
+    NCONFIG_ENTRY_LQUEUE_USE_WAIT,
+    NCONFIG_ENTRY_EPA_USE_URGENT_LANE,
+    NCONFIG_ENTRY_PQUEUE_PRIORITIES,
+    NCONFIG_ENTRY_MEMPOOL_USE_LOCK_FREE,
+    NCONFIG_ENTRY_MEMPOOL_USE_CACHE,
+    NCONFIG_ENTRY_MEMPOOL_CACHE_SIZE,
+    NCONFIG_ENTRY_EVENT_USE_HEAP,
+    NCONFIG_ENTRY_MEMPOOL_USE_LAZY_INIT,
+    NCONFIG_ENTRY_MEMPOOL_ALIGN,
+    NCONFIG_ENTRY_MEMPOOL_USE_MAPPED,
+    NCONFIG_ENTRY_EPA_USE_ARENA
 };
 
 struct nconfig_entry
@@ -18,9 +18,12 @@
 
 #include <stdint.h>
 
+#include "core/narena.h"
 #include "core/nconfig.h"
+#include "core/nerror.h"
 #include "core/nlqueue.h"
 #include "core/nsm.h"
+#include "core/nscheduler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,7 +34,7 @@ extern "C" {
  *  The EPA with this priority has the highest urgency to be selected and
  *  dispatched by scheduler.
  */
-#define NEPA_PRIO_MAX                   255
+#define NEPA_PRIO_MAX                   (NCONFIG_SCHEDULER_PRIORITIES - 1)
 
 /** @brief      The lowest EPA priority value
  *  @note       This priority level is reserved by Neon idle task.
@@ -57,11 +60,56 @@ extern "C" {
  *  @param      a_size
  *              Number of event this queue would hold.
  */
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
 #define nevent_queue(a_size)                                                \
-        nlqueue_dynamic_storage(const struct nevent *, a_size)
+        nlqueue_mpsc_storage(const struct nevent *, a_size)
+#else
+#define nevent_queue(a_size)                                                \
+        nlqueue_storage(const struct nevent *, a_size)
+#endif
+
+/** @brief      Initialize an EPA event queue using the queue storage.
+ *  @notapi
+ */
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+#define NP_EPA_EQUEUE_INITIALIZER(a_queue)                                  \
+        {                                                                   \
+            .super =                                                        \
+            {                                                               \
+                .producer =                                                 \
+                {                                                           \
+                    .index = 0u,                                            \
+                    .mask = NBITS_ARRAY_SIZE((a_queue)->np_lq_storage) - 1u,\
+                },                                                          \
+                .consumer =                                                 \
+                {                                                           \
+                    .index = 0u,                                            \
+                    .mask = NBITS_ARRAY_SIZE((a_queue)->np_lq_storage) - 1u,\
+                },                                                          \
+            },                                                              \
+            .np_lq_storage = &(a_queue)->np_lq_storage[0],                  \
+            .np_lq_sequence = &(a_queue)->np_lq_sequence[0],                \
+        }
+#else
+#define NP_EPA_EQUEUE_INITIALIZER(a_queue)                                  \
+        {                                                                   \
+            .super = NP_LQUEUE_SUPER_INITIALIZER(                           \
+                    NBITS_ARRAY_SIZE((a_queue)->np_lq_storage)),            \
+            .np_lq_storage = &(a_queue)->np_lq_storage[0],                  \
+        }
+#endif
 
-#if (NCONFIG_EPA_USE_HSM == 1) || defined(__DOXYGEN__)
 /** @brief      Initialize an Event Processing Agent (EPA)
+ *  
+ *  The EPA uses the default event budget @ref NCONFIG_EPA_EVENT_BUDGET. See
+ *  @ref NEPA_INITIALIZER_BUDGET for description of arguments.
+ */
+#define NEPA_INITIALIZER(a_queue, a_type_id, a_init_state, a_ws, a_prio)    \
+        NEPA_INITIALIZER_BUDGET(a_queue, a_type_id, a_init_state, a_ws,     \
+                a_prio, NCONFIG_EPA_EVENT_BUDGET)
+
+#if (NCONFIG_EPA_USE_HSM == 1) || defined(__DOXYGEN__)
+/** @brief      Initialize an Event Processing Agent (EPA) with event budget
  *  
  *  Each EPA is described by an event queue, state machine type, initial state
  *  and a workspace storage.
@@ -78,8 +126,17 @@ extern "C" {
  *              State machine workspace. A workspace pointer is just passed to
  *              state machine state functions. It is a void pointer, so any kind
  *              of additional data can be passed to the state functions.
+ *  @param      a_prio
+ *              EPA priority, a value in range @ref NEPA_PRIO_MIN + 1 up to
+ *              @ref NEPA_PRIO_MAX.
+ *  @param      a_budget
+ *              Maximum number of events dispatched in one EPA activation, a
+ *              value in range 1 up to @ref NCONFIG_EPA_EVENT_BUDGET. Use
+ *              smaller values for EPAs which must not delay higher priority
+ *              EPAs for long.
  */
-#define NEPA_INITIALIZER(a_queue, a_type_id, a_init_state, a_ws)            \
+#define NEPA_INITIALIZER_BUDGET(a_queue, a_type_id, a_init_state, a_ws,     \
+        a_prio, a_budget)                                                   \
         {                                                                   \
             .sm =                                                           \
             {                                                               \
@@ -90,40 +147,90 @@ extern "C" {
                 .state = (a_init_state),                                    \
                 .ws = (a_ws),                                               \
             },                                                              \
-            .equeue =                                                       \
+            .equeue = NP_EPA_EQUEUE_INITIALIZER(a_queue),                   \
+            .task =                                                         \
             {                                                               \
-                .super =                                                    \
-                {                                                           \
-                    .head = 0                                               \
-                    .tail = 1,                                              \
-                    .empty = NBITS_ARRAY_SIZE(&(a_queue)->np_lq_storage),   \
-                    .mask = NBITS_ARRAY_SIZE(&(a_queue)->np_lq_storage) - 1u,     \
-                },                                                          \
-                .np_lq_storage = &(a_queue)->np_lq_storage[0],              \
+                .prio = (a_prio),                                           \
             },                                                              \
+            .budget = (a_budget),                                           \
         }
 #else
-#define NEPA_INITIALIZER(a_queue, a_type_id, a_init_state, a_ws)            \
+#define NEPA_INITIALIZER_BUDGET(a_queue, a_type_id, a_init_state, a_ws,     \
+        a_prio, a_budget)                                                   \
         {                                                                   \
             .sm =                                                           \
             {                                                               \
                 .state = (a_init_state),                                    \
                 .ws = (a_ws),                                               \
             },                                                              \
-            .equeue =                                                       \
+            .equeue = NP_EPA_EQUEUE_INITIALIZER(a_queue),                   \
+            .task =                                                         \
             {                                                               \
-                .super =                                                    \
-                {                                                           \
-                    .head = 0,                                              \
-                    .tail = 1,                                              \
-                    .empty = NBITS_ARRAY_SIZE((a_queue)->np_lq_storage),    \
-                    .mask = NBITS_ARRAY_SIZE((a_queue)->np_lq_storage) - 1u,     \
-                },                                                          \
-                .np_lq_storage = &(a_queue)->np_lq_storage[0],              \
+                .prio = (a_prio),                                           \
             },                                                              \
+            .budget = (a_budget),                                           \
         }
 #endif
 
+#if (NCONFIG_EPA_USE_DEFER == 1) || defined(__DOXYGEN__)
+/** @brief      Attach a defer queue to an EPA.
+ *
+ *  The defer queue is defined in the same way as the event queue, see
+ *  @ref nevent_queue. An EPA without a defer queue can not defer events. This
+ *  macro must be used before the EPA is started.
+ *
+ *  @param      a_epa
+ *              Pointer to EPA.
+ *  @param      a_queue
+ *              Pointer to a defer queue.
+ *  @mseffect
+ */
+#define NEPA_DEFER_INIT(a_epa, a_queue)                                     \
+        do {                                                                \
+            NLQUEUE_INIT_DYNAMIC(&(a_epa)->dqueue,                          \
+                    sizeof((a_queue)->np_lq_storage), (a_queue));           \
+            (a_epa)->recalled = 0u;                                         \
+        } while (0)
+#endif
+
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1) || defined(__DOXYGEN__)
+/** @brief      Attach an urgent lane to an EPA.
+ *
+ *  The urgent lane is defined in the same way as the event queue, see
+ *  @ref nevent_queue. An EPA without an urgent lane can not receive urgent
+ *  events. This macro must be used before the EPA is started.
+ *
+ *  @param      a_epa
+ *              Pointer to EPA.
+ *  @param      a_queue
+ *              Pointer to an urgent lane queue.
+ *  @mseffect
+ */
+#define NEPA_URGENT_INIT(a_epa, a_queue)                                    \
+        NLQUEUE_INIT_DYNAMIC(&(a_epa)->uqueue,                              \
+                sizeof((a_queue)->np_lq_storage), (a_queue))
+#endif
+
+#if (NCONFIG_EPA_USE_ARENA == 1) || defined(__DOXYGEN__)
+/** @brief      Attach an arena to an EPA.
+ *
+ *  The arena is defined as described in @ref narena. State handlers of the
+ *  EPA allocate from the arena through the @a arena member and the arena is
+ *  reset after each dispatched event, so memory allocated by a state handler
+ *  is valid only until the handler returns. Several EPAs may share an arena
+ *  only when they never preempt each other and they are not dispatched
+ *  concurrently. This macro must be used before the EPA is started.
+ *
+ *  @param      a_epa
+ *              Pointer to EPA.
+ *  @param      a_arena
+ *              Pointer to an initialized arena.
+ *  @mseffect
+ */
+#define NEPA_ARENA_INIT(a_epa, a_arena)                                     \
+        (a_epa)->arena = NARENA(a_arena)
+#endif
+
 struct nscheduler;
 
 /** @brief      Event Processing Agent (EPA)
@@ -140,20 +247,218 @@ struct nepa
     
     /** @brief  Task management instance.
      */
-    struct ntask
-    {
-        uint_fast8_t                prio;
-    }                           task;           
+    struct nscheduler_task      task;           
     /** @brief  Event queue.
      */
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+    struct nequeue nlqueue_mpsc_dynamic(const struct nevent *)
+                                equeue;
+    /** @brief  Number of events put into the event queue and not yet
+     *          claimed by the EPA.
+     */
+    uint32_t                    pending;
+#else
     struct nequeue nlqueue_dynamic(const struct nevent *)
                                 equeue;         
+#endif
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1) || defined(__DOXYGEN__)
+    /** @brief  Urgent lane, see @ref NEPA_URGENT_INIT.
+     */
+    struct nequeue              uqueue;
+    /** @brief  Number of urgent events which were not sent since the urgent
+     *          lane was full.
+     */
+    uint32_t                    uoverflows;
+#endif
+    /** @brief  Maximum number of events dispatched in one activation.
+     */
+    uint_fast8_t                budget;
+#if (NCONFIG_EPA_USE_DEFER == 1) || defined(__DOXYGEN__)
+    /** @brief  Deferred event queue, see @ref NEPA_DEFER_INIT.
+     */
+    struct ndqueue nlqueue_dynamic(const struct nevent *)
+                                dqueue;
+    /** @brief  Number of recalled events at the defer queue head.
+     */
+    uint_fast8_t                recalled;
+#endif
+#if (NCONFIG_EPA_USE_PUBSUB == 1) || defined(__DOXYGEN__)
+    /** @brief  Subscribed signals, see @ref nepa_subscribe.
+     */
+    struct nepa_signals nbitarray(NCONFIG_EPA_PUBSUB_SIGNALS)
+                                signals;
+    /** @brief  Next subscribed EPA with the same priority.
+     */
+    struct nepa *               subscriber_next;
+    /** @brief  The EPA is in the subscriber list of its priority.
+     */
+    bool                        is_subscriber;
+#endif
+#if (NCONFIG_EPA_USE_ARENA == 1) || defined(__DOXYGEN__)
+    /** @brief  Scratch memory arena, see @ref NEPA_ARENA_INIT.
+     */
+    struct narena *             arena;
+#endif
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1) || defined(__DOXYGEN__)
+    /** @brief  Work-stealing pool link.
+     */
+    struct nepa_pool_link
+    {
+        struct nscheduler_pool *    pool;       /**< Pool executing the EPA.*/
+        struct nos_lock             lock;       /**< Protects event queue.  */
+        bool                        is_queued;  /**< EPA is in a worker queue
+                                                 *   or it is being executed.
+                                                 */
+    }                           pool;
+#endif
 };
 
+/** @brief      Send a predefined signal to an EPA.
+ *  @param      epa
+ *              Pointer to EPA which will receive the signal.
+ *  @param      signal
+ *              One of the predefined signals, see @ref nsm_signal.
+ *  @return     Error code, see @ref nepa_send_event.
+ */
 nerror nepa_send_signal(struct nepa * epa, uint_fast16_t signal);
 
+/** @brief      Send an event to an EPA.
+ *
+ *  The event is put into the EPA event queue and the EPA is marked as ready
+ *  in its scheduler ready queue.
+ *
+ *  @param      epa
+ *              Pointer to EPA which will receive the event.
+ *  @param      event
+ *              Pointer to event.
+ *  @return     Error code.
+ *  @retval     EOK - The event was put into the EPA queue.
+ *  @retval     EOBJ_INVALID - The EPA queue is full, the event was not sent.
+ */
 nerror nepa_send_event(struct nepa * epa, const struct nevent * event);
 
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1) || defined(__DOXYGEN__)
+/** @brief      Send a predefined signal to an EPA urgent lane.
+ *  @param      epa
+ *              Pointer to EPA which will receive the signal.
+ *  @param      signal
+ *              One of the predefined signals, see @ref nsm_signal.
+ *  @return     Error code, see @ref nepa_send_event_urgent.
+ */
+nerror nepa_send_signal_urgent(struct nepa * epa, uint_fast16_t signal);
+
+/** @brief      Send an urgent event to an EPA.
+ *
+ *  The event is put into the EPA urgent lane. Urgent events are dispatched in
+ *  the order they were sent, before any event waiting in the event queue.
+ *  Events already claimed in the current activation are dispatched first,
+ *  see @ref NEPA_INITIALIZER_BUDGET.
+ *
+ *  Each event which was not sent is counted in the EPA @a uoverflows member.
+ *
+ *  @param      epa
+ *              Pointer to EPA which will receive the event.
+ *  @param      event
+ *              Pointer to event.
+ *  @return     Error code.
+ *  @retval     EOK - The event was put into the EPA urgent lane.
+ *  @retval     EOBJ_INVALID - The urgent lane is full or the EPA has no
+ *              urgent lane, the event was not sent.
+ */
+nerror nepa_send_event_urgent(struct nepa * epa, const struct nevent * event);
+#endif
+
+#if (NCONFIG_EPA_USE_DEFER == 1) || defined(__DOXYGEN__)
+/** @brief      Defer an event.
+ *
+ *  The event is put into the EPA defer queue without copying. The EPA holds a
+ *  reference to the event until it is recalled and dispatched again. This
+ *  function is called from the EPA state function, usually with the event
+ *  which is currently being dispatched.
+ *
+ *  @param      epa
+ *              Pointer to EPA which defers the event.
+ *  @param      event
+ *              Pointer to event.
+ *  @return     Error code.
+ *  @retval     EOK - The event was deferred.
+ *  @retval     EOBJ_INVALID - The defer queue is full or the EPA has no defer
+ *              queue, the event was not deferred.
+ */
+nerror nepa_defer(struct nepa * epa, const struct nevent * event);
+
+/** @brief      Recall the oldest deferred event.
+ *
+ *  The recalled event stays at the defer queue head and it is dispatched
+ *  before any other event waiting in the EPA event queue, only urgent events
+ *  go first. Several recalled events are dispatched in the order they were
+ *  deferred. Events already claimed in the current activation are dispatched
+ *  first, see @ref NEPA_INITIALIZER_BUDGET. This function is called from the
+ *  EPA state function.
+ *
+ *  @param      epa
+ *              Pointer to EPA which recalls an event.
+ *  @return     Error code.
+ *  @retval     EOK - The event was recalled.
+ *  @retval     EOBJ_INVALID - There is no deferred event which is not already
+ *              recalled, no event was recalled.
+ */
+nerror nepa_recall(struct nepa * epa);
+#endif
+
+#if (NCONFIG_EPA_USE_PUBSUB == 1) || defined(__DOXYGEN__)
+/** @brief      Subscribe an EPA to a signal.
+ *
+ *  Any number of EPAs of the same priority may subscribe, also when they
+ *  belong to different schedulers or to a work-stealing pool.
+ *
+ *  @param      epa
+ *              Pointer to EPA which will receive published events.
+ *  @param      signal
+ *              Signal identifier, smaller than
+ *              @ref NCONFIG_EPA_PUBSUB_SIGNALS.
+ *  @return     Error code.
+ *  @retval     EOK - The EPA is subscribed.
+ *  @retval     EARG_OUTOFRANGE - The signal can not be published.
+ */
+nerror nepa_subscribe(struct nepa * epa, uint_fast16_t signal);
+
+/** @brief      Unsubscribe an EPA from a signal.
+ *  @param      epa
+ *              Pointer to EPA.
+ *  @param      signal
+ *              Signal identifier.
+ *  @return     Error code.
+ *  @retval     EOK - The EPA is not subscribed anymore.
+ *  @retval     EARG_OUTOFRANGE - The signal can not be published.
+ */
+nerror nepa_unsubscribe(struct nepa * epa, uint_fast16_t signal);
+
+/** @brief      Publish an event to all subscribed EPAs.
+ *
+ *  The subscribers receive the same event instance, starting with the
+ *  highest priority subscriber. Only priorities with a subscriber of the
+ *  signal are visited, but within such a priority all EPAs which subscribe to
+ *  any signal are checked, so the cost grows with the number of subscribers
+ *  which share a priority.
+ *
+ *  @param      event
+ *              Pointer to event. The event identifier selects subscribers.
+ *  @return     Error code.
+ *  @retval     EOK - The event was delivered to all subscribers.
+ *  @retval     EARG_OUTOFRANGE - The event identifier can not be published.
+ *  @retval     EOBJ_INVALID - The queue of at least one subscriber was full.
+ */
+nerror nepa_publish(const struct nevent * event);
+
+/** @brief      Publish a predefined signal to all subscribed EPAs.
+ *  @param      signal
+ *              One of the predefined signals, see @ref nsm_signal.
+ *  @return     Error code, see @ref nepa_publish.
+ */
+nerror nepa_publish_signal(uint_fast16_t signal);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
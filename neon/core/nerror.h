@@ -29,6 +29,8 @@ enum nerror_id
     EOBJ_INITIALIZED,                       /**< Object was already 
                                              *   initialized. */
     EARG_OUTOFRANGE,                        /**< Argument is out of range.    */
+    EMEM_EXHAUSTED,                         /**< Memory can not be allocated.
+                                             */
 };
 
 typedef enum nerror_id nerror;
@@ -9,10 +9,72 @@
  *  @brief      Event implementation
  *  @{ *//*==================================================================*/
 
+#include "core/nport.h"
+#include "core/nbits.h"
 #include "core/nevent.h"
 #include "core/nmempool.h"
 
-#if (NCONFIG_EVENT_USE_DYNAMIC == 1)
+#if (NCONFIG_EVENT_USE_HEAP == 1)
+/** @brief      Event heap pools, the pool at index K is the pool with the
+ *              smallest elements which hold at least 2^K bytes.
+ */
+static struct nmem_pool * g_event_heap[32];
+
+/* Class K holds the events of size greater than 2^(K - 1) and up to 2^K.
+ */
+static uint_fast8_t heap_class(size_t size)
+{
+    return (size > 1u) ? (uint_fast8_t)(narch_log2((uint32_t)size - 1u) + 1u) :
+            0u;
+}
+
+void nevent_heap_register(struct nmem_pool * pool)
+{
+    for (uint_fast8_t i = 0u; i < NBITS_ARRAY_SIZE(g_event_heap); i++) {
+        if (((uint32_t)1u << i) > pool->element_size) {
+            break;
+        }
+
+        if ((g_event_heap[i] == NULL) ||
+                (g_event_heap[i]->element_size > pool->element_size)) {
+            g_event_heap[i] = pool;
+        }
+    }
+}
+
+void * nevent_create(size_t size, uint_fast16_t id)
+{
+    struct nmem_pool * pool = NULL;
+    struct nevent * event = NULL;
+
+    if (size > ((uint32_t)1u << 31)) {
+        return NULL;
+    }
+
+    for (uint_fast8_t i = heap_class(size);
+            (event == NULL) && (i < NBITS_ARRAY_SIZE(g_event_heap)); i++) {
+        if (g_event_heap[i] == NULL) {
+            return NULL;
+        }
+
+        /* Consecutive classes are often served by the same pool.
+         */
+        if (g_event_heap[i] != pool) {
+            pool = g_event_heap[i];
+            event = nmem_pool_alloc(pool);
+        }
+    }
+
+    if (event == NULL) {
+        return NULL;
+    }
+    event->id = id;
+    event->ref = 0u;
+    event->pool = pool;
+
+    return event;
+}
+#elif (NCONFIG_EVENT_USE_DYNAMIC == 1)
 void * nevent_create(struct nmem_pool * pool, uint_fast16_t id)
 {
     struct nevent * event;
@@ -31,39 +93,51 @@ void * nevent_create(struct nmem_pool * pool, uint_fast16_t id)
 #endif
 
 #if (NCONFIG_EVENT_USE_DYNAMIC == 1)
-void event_delete(const struct nevent * event)
+void nevent_delete(const struct nevent * event)
 {
-    if (event_ref_down(event)) {
+    if (nevent_ref_down(event)) {
         nmem_pool_free(event->pool, (void *)event);
     }
 }
 #endif
 
 #if (NCONFIG_EVENT_USE_DYNAMIC == 1)
-void event_ref_up(const struct nevent * event)
+void nevent_ref_up(const struct nevent * event)
 {
     if (event->pool != NULL) {
         struct nevent * l_event = (struct nevent *)event;
+#if (NARCH_HAS_ATOMICS == 1)
+        (void)narch_atomic_inc_u16(&l_event->ref);
+#else
+        struct nos_critical local;
 
+        nos_critical_lock(&local);
         l_event->ref++;
+        nos_critical_unlock(&local);
+#endif
     }
 }
 #endif
 
 #if (NCONFIG_EVENT_USE_DYNAMIC == 1)
-static inline
-bool event_ref_down(const struct nevent * event)
+bool nevent_ref_down(const struct nevent * event)
 {
-    bool retval;
-
     if (event->pool != NULL) {
         struct nevent * l_event = (struct nevent *)event;
-        l_event->ref--;
-        retval = !(l_event->ref == 0u);
-    } else {
-        retval = false;
+#if (NARCH_HAS_ATOMICS == 1)
+        return narch_atomic_dec_u16(&l_event->ref) == 0u;
+#else
+        struct nos_critical local;
+        bool is_last;
+
+        nos_critical_lock(&local);
+        is_last = (--l_event->ref == 0u);
+        nos_critical_unlock(&local);
+
+        return is_last;
+#endif
     }
-    return retval;
+    return false;
 }
 #endif
 
@@ -16,6 +16,7 @@
 #ifndef NEON_EVENT_H_
 #define NEON_EVENT_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -41,26 +42,74 @@ struct nevent
 #endif /* (NCONFIG_EVENT_USE_DYNAMIC == 1) */
 };
 
-#if (NCONFIG_EVENT_USE_DYNAMIC == 1)
+#if (NCONFIG_EVENT_USE_HEAP == 1) || defined(__DOXYGEN__)
+/** @brief      Create a dynamic event from the event heap.
+ *
+ *  The size class of the event is found with @ref narch_log2, so the time to
+ *  find the pool does not depend on the number of registered pools. When the
+ *  pool of the class is exhausted the event is allocated from a pool of a
+ *  larger class.
+ *
+ *  @param      size
+ *              Size of the event structure, including @ref nevent.
+ *  @param      id
+ *              Event identifier.
+ *  @return     Pointer to event, or NULL when no pool of large enough class
+ *              has a free element.
+ */
+void * nevent_create(size_t size, uint_fast16_t id);
+
+/** @brief      Register a memory pool to the event heap.
+ *
+ *  The pool serves the events of all size classes up to the pool element
+ *  size, unless a pool with smaller elements serves that class.
+ *
+ *  @param      pool
+ *              Initialized memory pool.
+ *  @note       Register the pools before events are created.
+ */
+void nevent_heap_register(struct nmem_pool * pool);
+#elif (NCONFIG_EVENT_USE_DYNAMIC == 1)
+/** @brief      Create a dynamic event.
+ *  @param      pool
+ *              Memory pool from which the event is allocated.
+ *  @param      id
+ *              Event identifier.
+ *  @return     Pointer to event, or NULL when the pool is exhausted.
+ */
 void * nevent_create(struct nmem_pool * pool, uint_fast16_t id);
 #else
 #define nevent_create(a_pool, a_id)		NULL
 #endif
 
-#if (NCONFIG_EVENT_USE_DYNAMIC == 1)
+#if (NCONFIG_EVENT_USE_DYNAMIC == 1) || defined(__DOXYGEN__)
+/** @brief      Release a reference and free the event when it is not
+ *              referenced anymore.
+ *
+ *  Static events (events not created by @ref nevent_create) are never freed.
+ */
 void nevent_delete(const struct nevent * event);
 #else
 #define nevent_delete(a_event)
 #endif
 
-#if (NCONFIG_EVENT_USE_DYNAMIC == 1)
-static inline
-bool nevent_ref_up(const struct nevent * event);
+#if (NCONFIG_EVENT_USE_DYNAMIC == 1) || defined(__DOXYGEN__)
+/** @brief      Take a reference to a dynamic event.
+ *
+ *  On architectures with atomic operations the reference counter is updated
+ *  without entering a critical section, see @ref narch_atomic_inc_u16. Other
+ *  architectures lock the critical section.
+ */
+void nevent_ref_up(const struct nevent * event);
 #else
 #define nevent_ref_up(a_event)
 #endif
 
-#if (NCONFIG_EVENT_USE_DYNAMIC == 1)
+#if (NCONFIG_EVENT_USE_DYNAMIC == 1) || defined(__DOXYGEN__)
+/** @brief      Release a reference to a dynamic event.
+ *  @return     True when the released reference was the last one. Static
+ *              events always return false.
+ */
 bool nevent_ref_down(const struct nevent * event);
 #else
 #define nevent_ref_down(a_event)
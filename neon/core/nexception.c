@@ -9,11 +9,12 @@
  *  @brief      Error handling implementation
  *  @{ *//*==================================================================*/
 
+#include "core/nport.h"
 #include "core/nerror.h"
 
 void nexception_raise(enum nexception_id nexception_id)
 {
-
+    NPLATFORM_UNUSED_ARG(nexception_id);
 }
 
 /** @} */
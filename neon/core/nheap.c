@@ -0,0 +1,144 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+/** @file
+ *  @defgroup   nheap_impl Heap priority queue implementation
+ *  @brief      Heap priority queue implementation
+ *  @{ *//*==================================================================*/
+
+#include "core/nheap.h"
+
+#define HEAP_ARITY_LOG2                 2u
+
+/* Children of the entry at index I are at indices 4 * I + 1 to 4 * I + 4.
+ * The entries start at NP_HEAP_ROOT in the aligned heap array, so each
+ * sibling group starts on a 4 entry boundary and shares a single cache line.
+ */
+#define heap_parent(a_index)            (((a_index) - 1u) >> HEAP_ARITY_LOG2)
+#define heap_child(a_index)             (((a_index) << HEAP_ARITY_LOG2) + 1u)
+
+static bool key_is_before(uint32_t key, uint32_t other)
+{
+    return (int32_t)(key - other) < 0;
+}
+
+static void heap_place(struct nheap * heap, uint32_t index,
+        const struct nheap_entry * entry)
+{
+    heap->entries[index] = *entry;
+    entry->node->index = index;
+}
+
+static void heap_sift_up(struct nheap * heap, uint32_t index)
+{
+    struct nheap_entry entry = heap->entries[index];
+
+    while (index != 0u) {
+        uint32_t parent = heap_parent(index);
+
+        if (!key_is_before(entry.key, heap->entries[parent].key)) {
+            break;
+        }
+        heap_place(heap, index, &heap->entries[parent]);
+        index = parent;
+    }
+    heap_place(heap, index, &entry);
+}
+
+static void heap_sift_down(struct nheap * heap, uint32_t index)
+{
+    struct nheap_entry entry = heap->entries[index];
+
+    for (;;) {
+        uint32_t child = heap_child(index);
+        uint32_t last;
+        uint32_t smallest;
+
+        if (child >= heap->count) {
+            break;
+        }
+        last = child + (1u << HEAP_ARITY_LOG2);
+
+        if (last > heap->count) {
+            last = heap->count;
+        }
+        smallest = child;
+
+        while (++child < last) {
+            if (key_is_before(heap->entries[child].key,
+                    heap->entries[smallest].key)) {
+                smallest = child;
+            }
+        }
+
+        if (!key_is_before(heap->entries[smallest].key, entry.key)) {
+            break;
+        }
+        heap_place(heap, index, &heap->entries[smallest]);
+        index = smallest;
+    }
+    heap_place(heap, index, &entry);
+}
+
+void nheap_init(struct nheap * heap, struct nheap_entry * entries,
+        uint32_t size)
+{
+    heap->entries = entries;
+    heap->count = 0u;
+    heap->size = size;
+}
+
+nerror nheap_insert(struct nheap * heap, struct nheap_node * node,
+        uint32_t key)
+{
+    uint32_t index;
+
+    if (heap->count == heap->size) {
+        return -EOBJ_INVALID;
+    }
+    index = heap->count++;
+    heap->entries[index].key = key;
+    heap->entries[index].node = node;
+    heap_sift_up(heap, index);
+
+    return EOK;
+}
+
+void nheap_remove(struct nheap * heap, struct nheap_node * node)
+{
+    uint32_t index = node->index;
+    uint32_t last = --heap->count;
+
+    if (index == last) {
+        return;
+    }
+    heap_place(heap, index, &heap->entries[last]);
+
+    if ((index != 0u) && key_is_before(heap->entries[index].key,
+            heap->entries[heap_parent(index)].key)) {
+        heap_sift_up(heap, index);
+    } else {
+        heap_sift_down(heap, index);
+    }
+}
+
+struct nheap_node * nheap_remove_head(struct nheap * heap)
+{
+    struct nheap_node * head = heap->entries[0].node;
+
+    nheap_remove(heap, head);
+
+    return head;
+}
+
+void nheap_decrease_key(struct nheap * heap, struct nheap_node * node,
+        uint32_t key)
+{
+    heap->entries[node->index].key = key;
+    heap_sift_up(heap, node->index);
+}
+
+/** @} */
@@ -0,0 +1,219 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+/** @file
+ *  @addtogroup neon
+ *  @{
+ */
+/** @defgroup   nheap Heap priority queue
+ *  @brief      Heap priority queue
+ *
+ *  The heap is a 4-ary min heap of intrusive nodes with 32-bit keys. It is
+ *  used when the range of priorities is too wide for @ref npqueue, like
+ *  deadlines. The heap array holds the keys next to node pointers, so the
+ *  nodes are not accessed while the keys are compared.
+ *
+ *  The keys are compared as wrapping counters: key A comes before key B when
+ *  (int32_t)(A - B) is negative. All keys in a heap must be within 2^31 of
+ *  each other.
+ *  @{
+ */
+
+#ifndef NEON_HEAP_H_
+#define NEON_HEAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core/nport.h"
+#include "core/nbits.h"
+#include "core/nerror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief      Heap node structure.
+ *
+ *  The node is embedded into a structure which is put into a heap. Use
+ *  @a NPLATFORM_CONTAINER_OF to get the structure from node pointer.
+ */
+struct nheap_node
+{
+    uint32_t index;                             /**< Position in heap. */
+};
+
+/** @brief      Heap array element.
+ *  @notapi
+ */
+struct nheap_entry
+{
+    uint32_t key;
+    struct nheap_node * node;
+};
+
+/** @brief      Heap base structure.
+ *  @notapi
+ */
+struct nheap
+{
+    struct nheap_entry * entries;
+    uint32_t count;
+    uint32_t size;
+};
+
+/** @brief      Position of the heap root in the heap array.
+ *
+ *  The root is placed at the end of the first group of 4 entries, so the
+ *  children of every entry start at a multiple of 4 entries from the aligned
+ *  array start and all 4 siblings are in a single cache line, as long as 4
+ *  entries fit into one.
+ *
+ *  @notapi
+ */
+#define NP_HEAP_ROOT                    3u
+
+/** @brief      Heap custom structure.
+ *
+ *  Contains the Base structure and the heap array which holds at most
+ *  @a size nodes. The heap array is aligned to @a NARCH_CACHE_LINE.
+ *
+ *  @code
+ *  struct deadline_heap nheap(64);
+ *  @endcode
+ *
+ *  @param      size
+ *              Maximum number of nodes in heap.
+ */
+#define nheap(size)                                                         \
+    {                                                                       \
+        struct nheap super;                                                 \
+        NPLATFORM_ALIGN(NARCH_CACHE_LINE,                                   \
+                struct nheap_entry np_heap_storage[NP_HEAP_ROOT + (size)]); \
+    }
+
+/** @brief      Initialize a heap.
+ *  @param      H
+ *              Pointer to heap defined by @ref nheap.
+ *  @mseffect
+ */
+#define NHEAP_INIT(H)                                                       \
+        nheap_init(                                                         \
+                &(H)->super,                                                \
+                &(H)->np_heap_storage[NP_HEAP_ROOT],                        \
+                NBITS_ARRAY_SIZE((H)->np_heap_storage) - NP_HEAP_ROOT)
+
+/** @brief      Insert a node with the given key.
+ *  @param      H
+ *              Pointer to heap.
+ *  @param      a_node
+ *              Pointer to heap node.
+ *  @param      a_key
+ *              Node key.
+ *  @return     Error code.
+ *  @retval     EOK - The node was inserted.
+ *  @retval     EOBJ_INVALID - The heap is full, the node was not inserted.
+ */
+#define NHEAP_INSERT(H, a_node, a_key)                                      \
+        nheap_insert(&(H)->super, (a_node), (a_key))
+
+/** @brief      Remove a node from the heap.
+ *  @param      H
+ *              Pointer to heap.
+ *  @param      a_node
+ *              Pointer to heap node which is in the heap.
+ */
+#define NHEAP_REMOVE(H, a_node)                                             \
+        nheap_remove(&(H)->super, (a_node))
+
+/** @brief      Remove and return the node with the smallest key.
+ *  @param      H
+ *              Pointer to heap.
+ *  @note       Before calling this macro ensure that the heap is not empty,
+ *              see @ref NHEAP_IS_EMPTY.
+ */
+#define NHEAP_REMOVE_HEAD(H)            nheap_remove_head(&(H)->super)
+
+/** @brief      Lower the key of a node which is in the heap.
+ *  @param      H
+ *              Pointer to heap.
+ *  @param      a_node
+ *              Pointer to heap node.
+ *  @param      a_key
+ *              New key which must not come after the current node key.
+ */
+#define NHEAP_DECREASE_KEY(H, a_node, a_key)                                \
+        nheap_decrease_key(&(H)->super, (a_node), (a_key))
+
+/** @brief      Peek to the node with the smallest key.
+ *  @param      H
+ *              Pointer to heap.
+ */
+#define NHEAP_HEAD(H)                   ((H)->super.entries[0].node)
+
+/** @brief      Return the smallest key in heap.
+ *  @param      H
+ *              Pointer to heap.
+ */
+#define NHEAP_HEAD_KEY(H)               ((H)->super.entries[0].key)
+
+/** @brief      Return the key of a node which is in the heap.
+ *  @param      H
+ *              Pointer to heap.
+ *  @param      a_node
+ *              Pointer to heap node.
+ */
+#define NHEAP_KEY(H, a_node)                                                \
+        ((H)->super.entries[(a_node)->index].key)
+
+/** @brief      Returns the number of nodes in heap.
+ */
+#define NHEAP_COUNT(H)                  ((H)->super.count)
+
+/** @brief      Return true if heap is empty else false.
+ */
+#define NHEAP_IS_EMPTY(H)               ((H)->super.count == 0u)
+
+/** @brief      Return true if heap is full else false.
+ */
+#define NHEAP_IS_FULL(H)                ((H)->super.count == (H)->super.size)
+
+/** @brief      Initialise the heap base.
+ *  @notapi
+ */
+void nheap_init(struct nheap * heap, struct nheap_entry * entries,
+        uint32_t size);
+
+/** @brief      Insert a node into the heap.
+ *  @notapi
+ */
+nerror nheap_insert(struct nheap * heap, struct nheap_node * node,
+        uint32_t key);
+
+/** @brief      Remove a node from the heap.
+ *  @notapi
+ */
+void nheap_remove(struct nheap * heap, struct nheap_node * node);
+
+/** @brief      Remove the node with the smallest key.
+ *  @notapi
+ */
+struct nheap_node * nheap_remove_head(struct nheap * heap);
+
+/** @brief      Lower the node key.
+ *  @notapi
+ */
+void nheap_decrease_key(struct nheap * heap, struct nheap_node * node,
+        uint32_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+/** @} */
+
+#endif /* NEON_HEAP_H_ */
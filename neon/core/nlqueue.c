@@ -9,9 +9,29 @@
  *  @brief      Lightweight queue implementation
  *  @{ *//*==================================================================*/
 
+#include <string.h>
+
 #include "core/nlqueue.h"
 
-void np_lqueue_super_init(struct nlqueue * lqs, uint16_t elements)
+#if (NCONFIG_LQUEUE_USE_LARGE == 1)
+void np_lqueue_super_init(struct nlqueue * lqs, uint32_t elements)
+{
+    lqs->head = 0u;
+    lqs->tail = 0u;
+    lqs->mask = elements - 1u;
+}
+
+nlqueue_idx np_lqueue_super_head(const struct nlqueue * qb)
+{
+    return qb->head & qb->mask;
+}
+
+nlqueue_idx np_lqueue_super_tail(const struct nlqueue * qb)
+{
+    return (qb->tail - 1u) & qb->mask;
+}
+#else
+void np_lqueue_super_init(struct nlqueue * lqs, uint32_t elements)
 {
     lqs->head = 0u;
     lqs->tail = 1u;
@@ -19,9 +39,9 @@ void np_lqueue_super_init(struct nlqueue * lqs, uint16_t elements)
     lqs->mask = elements - 1u;
 }
 
-int_fast8_t np_lqueue_super_head(const struct nlqueue * qb)
+nlqueue_idx np_lqueue_super_head(const struct nlqueue * qb)
 {
-    int_fast8_t real_head;
+    nlqueue_idx real_head;
 
     real_head = qb->head;
     real_head++;
@@ -30,9 +50,9 @@ int_fast8_t np_lqueue_super_head(const struct nlqueue * qb)
     return real_head;
 }
 
-int_fast8_t np_lqueue_super_tail(const struct nlqueue * qb)
+nlqueue_idx np_lqueue_super_tail(const struct nlqueue * qb)
 {
-    int_fast8_t real_tail;
+    nlqueue_idx real_tail;
 
     real_tail = qb->tail;
     real_tail--;
@@ -40,5 +60,252 @@ int_fast8_t np_lqueue_super_tail(const struct nlqueue * qb)
 
     return real_tail;
 }
+#endif
+
+void np_lqueue_super_put_n(
+        struct nlqueue * qb,
+        void * storage,
+        size_t item_size,
+        const void * items,
+        nlqueue_idx n)
+{
+    nlqueue_idx first;
+
+    first = nlqueue_super_put_reserve(qb);
+
+    if (first > n) {
+        first = n;
+    }
+    memcpy((uint8_t *)storage + nlqueue_super_idx_put(qb) * item_size, items,
+            first * item_size);
+    memcpy(storage, (const uint8_t *)items + first * item_size,
+            (n - first) * item_size);
+    nlqueue_super_put_commit(qb, n);
+}
+
+void np_lqueue_super_get_n(
+        struct nlqueue * qb,
+        const void * storage,
+        size_t item_size,
+        void * items,
+        nlqueue_idx n)
+{
+    nlqueue_idx first;
+
+    first = nlqueue_super_get_reserve(qb);
+
+    if (first > n) {
+        first = n;
+    }
+    memcpy(items,
+            (const uint8_t *)storage + np_lqueue_super_head(qb) * item_size,
+            first * item_size);
+    memcpy((uint8_t *)items + first * item_size, storage,
+            (n - first) * item_size);
+    nlqueue_super_get_commit(qb, n);
+}
+
+void np_lqueue_spsc_init(struct nlqueue_spsc * qs, uint32_t elements)
+{
+    qs->producer.index = 0u;
+    qs->producer.cached = 0u;
+    qs->producer.mask = elements - 1u;
+    qs->consumer.index = 0u;
+    qs->consumer.cached = 0u;
+    qs->consumer.mask = elements - 1u;
+}
+
+void np_lqueue_mpsc_init(struct nlqueue_mpsc * qm, uint32_t elements)
+{
+    qm->producer.index = 0u;
+    qm->producer.mask = elements - 1u;
+    qm->consumer.index = 0u;
+    qm->consumer.mask = elements - 1u;
+}
+
+/* A slot sequence number is kept relative to the slot index. The slot is free
+ * for position P when its sequence equals the base of the P lap, and it holds
+ * an item put at position P when its sequence equals the lap base plus one.
+ */
+bool np_lqueue_mpsc_reserve(
+        struct nlqueue_mpsc * qm,
+        uint32_t * sequence,
+        uint32_t * position)
+{
+    uint32_t index = narch_atomic_load_u32(&qm->producer.index);
+
+    for (;;) {
+        uint32_t lap = index & ~qm->producer.mask;
+        int32_t diff;
+
+        diff = (int32_t)(narch_atomic_load_u32(
+                &sequence[index & qm->producer.mask]) - lap);
+
+        if (diff == 0) {
+            if (narch_atomic_cas_u32(&qm->producer.index, index, index + 1u)) {
+                *position = index;
+
+                return true;
+            }
+        } else if (diff < 0) {
+            /* The slot still holds an item of the previous lap.
+             */
+            return false;
+        }
+        index = narch_atomic_load_u32(&qm->producer.index);
+    }
+}
+
+void np_lqueue_broadcast_init(struct nlqueue_broadcast * qb, uint32_t elements)
+{
+    qb->index = 0u;
+    qb->mask = elements - 1u;
+    qb->cached = 0u;
+    qb->readers = NULL;
+}
+
+void np_lqueue_broadcast_subscribe(
+        struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader,
+        bool is_lossy)
+{
+    reader->cursor = qb->index;
+    reader->lost = 0u;
+    reader->is_lossy = is_lossy;
+    reader->next = qb->readers;
+    qb->readers = reader;
+}
+
+void np_lqueue_broadcast_unsubscribe(
+        struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader)
+{
+    struct nlqueue_reader ** link;
+
+    for (link = &qb->readers; *link != NULL; link = &(*link)->next) {
+        if (*link == reader) {
+            *link = reader->next;
+            break;
+        }
+    }
+}
+
+uint32_t np_lqueue_broadcast_gate(struct nlqueue_broadcast * qb)
+{
+    const struct nlqueue_reader * reader;
+    uint32_t slowest = 0u;
+
+    for (reader = qb->readers; reader != NULL; reader = reader->next) {
+        if (!reader->is_lossy) {
+            uint32_t pending;
+
+            pending = qb->index - narch_atomic_load_u32(&reader->cursor);
+
+            if (pending > slowest) {
+                slowest = pending;
+            }
+        }
+    }
+    qb->cached = qb->index - slowest;
+
+    return slowest;
+}
+
+/* While the producer writes the item at index I it overwrites the item at
+ * I - size, so the oldest item a lossy reader may still read is the one at
+ * I - size + 1.
+ */
+bool np_lqueue_broadcast_claim(
+        const struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader)
+{
+    uint32_t index = narch_atomic_load_u32(&qb->index);
+
+    if (index == reader->cursor) {
+        return false;
+    }
+
+    if (reader->is_lossy && ((index - reader->cursor) > qb->mask)) {
+        reader->lost += index - reader->cursor - qb->mask;
+        reader->cursor = index - qb->mask;
+    }
+    return true;
+}
+
+#if (NCONFIG_LQUEUE_USE_WAIT == 1)
+void np_lqueue_wait_init(struct nlqueue_wait * qw)
+{
+    qw->lock.state = 0u;
+    qw->put_sequence = 0u;
+    qw->get_sequence = 0u;
+    qw->getters = 0u;
+    qw->putters = 0u;
+}
+
+/* The sequence word is read under the lock and it is changed only under the
+ * lock, so a wake-up sent after the lock is released by the waiter is never
+ * lost: either the word has changed and the wait returns immediately, or the
+ * waiter is already sleeping.
+ */
+void np_lqueue_wait_put_lock(struct nlqueue_wait * qw,
+        const struct nlqueue * qb)
+{
+    nos_lock_acquire(&qw->lock);
+
+    while (nlqueue_super_empty(qb) == 0u) {
+        uint32_t sequence = qw->get_sequence;
+
+        qw->putters++;
+        nos_lock_release(&qw->lock);
+        nos_word_wait(&qw->get_sequence, sequence);
+        nos_lock_acquire(&qw->lock);
+        qw->putters--;
+    }
+}
+
+void np_lqueue_wait_put_unlock(struct nlqueue_wait * qw)
+{
+    bool is_waiting = qw->getters != 0u;
+
+    if (is_waiting) {
+        narch_atomic_store_u32(&qw->put_sequence, qw->put_sequence + 1u);
+    }
+    nos_lock_release(&qw->lock);
+
+    if (is_waiting) {
+        nos_word_wake(&qw->put_sequence, 1u);
+    }
+}
+
+void np_lqueue_wait_get_lock(struct nlqueue_wait * qw,
+        const struct nlqueue * qb)
+{
+    nos_lock_acquire(&qw->lock);
+
+    while (nlqueue_super_empty(qb) > qb->mask) {
+        uint32_t sequence = qw->put_sequence;
+
+        qw->getters++;
+        nos_lock_release(&qw->lock);
+        nos_word_wait(&qw->put_sequence, sequence);
+        nos_lock_acquire(&qw->lock);
+        qw->getters--;
+    }
+}
+
+void np_lqueue_wait_get_unlock(struct nlqueue_wait * qw)
+{
+    bool is_waiting = qw->putters != 0u;
+
+    if (is_waiting) {
+        narch_atomic_store_u32(&qw->get_sequence, qw->get_sequence + 1u);
+    }
+    nos_lock_release(&qw->lock);
+
+    if (is_waiting) {
+        nos_word_wake(&qw->get_sequence, 1u);
+    }
+}
+#endif /* (NCONFIG_LQUEUE_USE_WAIT == 1) */
 
 /** @} */
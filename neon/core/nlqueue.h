@@ -16,8 +16,10 @@
 #ifndef NEON_LQUEUE_H_
 #define NEON_LQUEUE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "core/nconfig.h"
 #include "core/nport.h"
 #include "core/nbits.h"
 
@@ -69,9 +71,30 @@ extern "C" {
     }
 
 
+/** @brief      Lightweight queue index type.
+ */
+#if (NCONFIG_LQUEUE_USE_LARGE == 1)
+typedef uint32_t nlqueue_idx;
+#else
+typedef uint_fast16_t nlqueue_idx;
+#endif
+
 /** @brief      Lightweight base structure.
+ *
+ *  In large queue mode the @a head and @a tail are free running counters of
+ *  got and put items. The number of items is their difference and they are
+ *  masked only when the queue buffer is accessed.
+ *
  *  @notapi
  */
+#if (NCONFIG_LQUEUE_USE_LARGE == 1)
+struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
+{
+    uint32_t                    head;
+    uint32_t                    tail;
+    uint32_t                    mask;
+};
+#else
 struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
 {
     uint_fast16_t               head;
@@ -79,6 +102,28 @@ struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
     uint_fast16_t               empty;
     uint_fast16_t               mask;
 };
+#endif
+
+/** @brief      Initialize the base structure of a queue with @a a_elements
+ *              elements in a static initializer.
+ *  @notapi
+ */
+#if (NCONFIG_LQUEUE_USE_LARGE == 1)
+#define NP_LQUEUE_SUPER_INITIALIZER(a_elements)                             \
+        {                                                                   \
+            .head = 0u,                                                     \
+            .tail = 0u,                                                     \
+            .mask = (a_elements) - 1u,                                      \
+        }
+#else
+#define NP_LQUEUE_SUPER_INITIALIZER(a_elements)                             \
+        {                                                                   \
+            .head = 0u,                                                     \
+            .tail = 1u,                                                     \
+            .empty = (a_elements),                                          \
+            .mask = (a_elements) - 1u,                                      \
+        }
+#endif
 
 /** @brief      Initialize a dynamic queue structure
  *  @param      Q
@@ -176,6 +221,102 @@ struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
 #define NLQUEUE_GET(Q)                                                      \
         (Q)->np_lq_storage[nlqueue_super_idx_get(&(Q)->super)]
 
+/** @brief      Put a number of items to queue in FIFO mode.
+ *
+ *  The items are copied with at most two copy operations, one up to the end
+ *  of queue buffer and one from the beginning of the buffer.
+ *
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ *  @param      a_items
+ *              Pointer to array of items.
+ *  @param      a_n
+ *              Number of items in the array.
+ *  @note       Before calling this function ensure that queue has at least
+ *              @a a_n free elements, see @ref NLQUEUE_EMPTY.
+ *  @mseffect
+ */
+#define NLQUEUE_PUT_N(Q, a_items, a_n)                                      \
+        np_lqueue_super_put_n(                                              \
+                &(Q)->super,                                                \
+                (Q)->np_lq_storage,                                         \
+                sizeof((Q)->np_lq_storage[0]),                              \
+                (a_items),                                                  \
+                (a_n))
+
+/** @brief      Get a number of items from the queue buffer.
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ *  @param      a_items
+ *              Pointer to array which receives the items.
+ *  @param      a_n
+ *              Number of items to get.
+ *  @note       Before calling this function ensure that queue has at least
+ *              @a a_n items, see @ref NLQUEUE_OCCUPIED.
+ *  @mseffect
+ */
+#define NLQUEUE_GET_N(Q, a_items, a_n)                                      \
+        np_lqueue_super_get_n(                                              \
+                &(Q)->super,                                                \
+                (Q)->np_lq_storage,                                         \
+                sizeof((Q)->np_lq_storage[0]),                              \
+                (a_items),                                                  \
+                (a_n))
+
+/** @brief      Reserve a contiguous free region at the queue tail.
+ *
+ *  The items are written directly into the queue buffer and then they are
+ *  put into queue with @ref NLQUEUE_PUT_COMMIT. The region ends at the end
+ *  of queue buffer, so it may be smaller than the number of free elements.
+ *
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ *  @param      a_count
+ *              An lvalue which receives the number of elements in the region.
+ *  @return     Pointer to the first element of the region.
+ *  @mseffect
+ */
+#define NLQUEUE_PUT_RESERVE(Q, a_count)                                     \
+        ((a_count) = nlqueue_super_put_reserve(&(Q)->super),                \
+         &(Q)->np_lq_storage[nlqueue_super_idx_put(&(Q)->super)])
+
+/** @brief      Put the items written into a reserved region to queue.
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ *  @param      a_n
+ *              Number of written items, not bigger than the region size.
+ *  @mseffect
+ */
+#define NLQUEUE_PUT_COMMIT(Q, a_n)                                          \
+        nlqueue_super_put_commit(&(Q)->super, (a_n))
+
+/** @brief      Reserve a contiguous filled region at the queue head.
+ *
+ *  The items are read directly from the queue buffer and then they are
+ *  removed from queue with @ref NLQUEUE_GET_COMMIT. The region ends at the
+ *  end of queue buffer, so it may be smaller than the number of items.
+ *
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ *  @param      a_count
+ *              An lvalue which receives the number of items in the region.
+ *  @return     Pointer to the first item of the region.
+ *  @mseffect
+ */
+#define NLQUEUE_GET_RESERVE(Q, a_count)                                     \
+        ((a_count) = nlqueue_super_get_reserve(&(Q)->super),                \
+         &(Q)->np_lq_storage[np_lqueue_super_head(&(Q)->super)])
+
+/** @brief      Remove the items of a reserved region from queue.
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ *  @param      a_n
+ *              Number of read items, not bigger than the region size.
+ *  @mseffect
+ */
+#define NLQUEUE_GET_COMMIT(Q, a_n)                                          \
+        nlqueue_super_get_commit(&(Q)->super, (a_n))
+
 /** @brief      Peek to queue head; the item is not removed from queue.
  *
  *  Get the pointer to head item in the queue. The item is not removed from
@@ -204,13 +345,19 @@ struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
  *  @param      Q
  *              Pointer to lightweight queue.
  */
-#define NLQUEUE_SIZE(Q)                 (Q)->super.mask + 1u
+#define NLQUEUE_SIZE(Q)                 ((Q)->super.mask + 1u)
 
 /** @brief      Returns the current number of free elements in queue buffer.
  *  @param      Q
  *              Pointer to lightweight queue.
  */
-#define NLQUEUE_EMPTY(Q)                (Q)->super.empty
+#define NLQUEUE_EMPTY(Q)                nlqueue_super_empty(&(Q)->super)
+
+/** @brief      Returns the current number of items in queue buffer.
+ *  @param      Q
+ *              Pointer to lightweight queue.
+ */
+#define NLQUEUE_OCCUPIED(Q)             (NLQUEUE_SIZE(Q) - NLQUEUE_EMPTY(Q))
 
 /** @brief      Return true if queue is full else false.
  *  @param      Q
@@ -229,7 +376,7 @@ struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
  *              Pointer to lightweight queue.
  */
 #define NLQUEUE_IS_FIRST(Q)                                                 \
-        ((Q)->super.empty == (Q)->super.mask)
+        (NLQUEUE_EMPTY(Q) == (Q)->super.mask)
 
 /** @brief      Initialise the base queue structure.
  *  @param      lqs
@@ -237,7 +384,137 @@ struct NPLATFORM_ALIGN(NARCH_ALIGN, nlqueue)
  *  @param      elements
  *  @notapi
  */
-void np_lqueue_super_init(struct nlqueue * lqs, uint16_t elements);
+void np_lqueue_super_init(struct nlqueue * lqs, uint32_t elements);
+
+#if (NCONFIG_LQUEUE_USE_LARGE == 1)
+/** @brief      Returns the current number of free elements in queue buffer.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_empty(const struct nlqueue * qb)
+{
+    return qb->mask + 1u - (qb->tail - qb->head);
+}
+
+/** @brief      Put an item to queue in FIFO mode.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @return     Index of the item where it should be put.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_idx_fifo(struct nlqueue * qb)
+{
+    if ((qb->tail - qb->head) > qb->mask) {
+        qb->head++;
+    }
+    return qb->tail++ & qb->mask;
+}
+
+/** @brief      Put an item to queue in LIFO mode.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @return     Index of the item where it should be put.
+ *  @notapi
+ */
+static inline
+int32_t nlqueue_super_idx_lifo(struct nlqueue * qb)
+{
+    if ((qb->tail - qb->head) > qb->mask) {
+        return -1;
+    }
+    return (int32_t)(--qb->head & qb->mask);
+}
+
+/** @brief      Get an item from the queue buffer.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @return     Index of the item which was got from the queue.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_idx_get(struct nlqueue * qb)
+{
+    return qb->head++ & qb->mask;
+}
+
+/** @brief      Returns the index where the next item will be put.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_idx_put(const struct nlqueue * qb)
+{
+    return qb->tail & qb->mask;
+}
+
+/** @brief      Returns the size of contiguous free region at queue tail.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_put_reserve(const struct nlqueue * qb)
+{
+    nlqueue_idx empty = nlqueue_super_empty(qb);
+    nlqueue_idx to_end = qb->mask + 1u - (qb->tail & qb->mask);
+
+    return empty < to_end ? empty : to_end;
+}
+
+/** @brief      Put the items of reserved region to queue.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @param      n
+ *              Number of items.
+ *  @notapi
+ */
+static inline
+void nlqueue_super_put_commit(struct nlqueue * qb, nlqueue_idx n)
+{
+    qb->tail += n;
+}
+
+/** @brief      Returns the size of contiguous filled region at queue head.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_get_reserve(const struct nlqueue * qb)
+{
+    nlqueue_idx occupied = qb->tail - qb->head;
+    nlqueue_idx to_end = qb->mask + 1u - (qb->head & qb->mask);
+
+    return occupied < to_end ? occupied : to_end;
+}
+
+/** @brief      Remove the items of reserved region from queue.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @param      n
+ *              Number of items.
+ *  @notapi
+ */
+static inline
+void nlqueue_super_get_commit(struct nlqueue * qb, nlqueue_idx n)
+{
+    qb->head += n;
+}
+#else
+/** @brief      Returns the current number of free elements in queue buffer.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_empty(const struct nlqueue * qb)
+{
+    return qb->empty;
+}
 
 /** @brief      Put an item to queue in FIFO mode.
  *  @param      qb
@@ -246,9 +523,9 @@ void np_lqueue_super_init(struct nlqueue * lqs, uint16_t elements);
  *  @notapi
  */
 static inline
-int_fast8_t nlqueue_super_idx_fifo(struct nlqueue * qb)
+nlqueue_idx nlqueue_super_idx_fifo(struct nlqueue * qb)
 {
-    int_fast8_t retval;
+    nlqueue_idx retval;
 
     retval = qb->tail++;
     qb->tail &= qb->mask;
@@ -290,7 +567,7 @@ int32_t nlqueue_super_idx_lifo(struct nlqueue * qb)
  *  @notapi
  */
 static inline
-int_fast8_t nlqueue_super_idx_get(struct nlqueue * qb)
+nlqueue_idx nlqueue_super_idx_get(struct nlqueue * qb)
 {
     qb->head++;
     qb->head &= qb->mask;
@@ -299,21 +576,941 @@ int_fast8_t nlqueue_super_idx_get(struct nlqueue * qb)
     return qb->head;
 }
 
+/** @brief      Returns the index where the next item will be put.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_idx_put(const struct nlqueue * qb)
+{
+    return qb->tail;
+}
+
+/** @brief      Returns the size of contiguous free region at queue tail.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_put_reserve(const struct nlqueue * qb)
+{
+    nlqueue_idx to_end = qb->mask + 1u - qb->tail;
+
+    return qb->empty < to_end ? qb->empty : to_end;
+}
+
+/** @brief      Put the items of reserved region to queue.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @param      n
+ *              Number of items.
+ *  @notapi
+ */
+static inline
+void nlqueue_super_put_commit(struct nlqueue * qb, nlqueue_idx n)
+{
+    qb->tail += n;
+    qb->tail &= qb->mask;
+    qb->empty -= n;
+}
+
+/** @brief      Returns the size of contiguous filled region at queue head.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @notapi
+ */
+static inline
+nlqueue_idx nlqueue_super_get_reserve(const struct nlqueue * qb)
+{
+    nlqueue_idx occupied = qb->mask + 1u - qb->empty;
+    nlqueue_idx to_end = qb->mask - qb->head;
+
+    /* Head points to the element before the first item, so the region of
+     * the first item which is at index 0 spans the whole buffer.
+     */
+    if (to_end == 0u) {
+        to_end = qb->mask + 1u;
+    }
+    return occupied < to_end ? occupied : to_end;
+}
+
+/** @brief      Remove the items of reserved region from queue.
+ *  @param      qb
+ *              Pointer to lightweight queue base.
+ *  @param      n
+ *              Number of items.
+ *  @notapi
+ */
+static inline
+void nlqueue_super_get_commit(struct nlqueue * qb, nlqueue_idx n)
+{
+    qb->head += n;
+    qb->head &= qb->mask;
+    qb->empty += n;
+}
+#endif
+
+/** @brief      Copy a number of items into queue buffer.
+ *  @notapi
+ */
+void np_lqueue_super_put_n(
+        struct nlqueue * qb,
+        void * storage,
+        size_t item_size,
+        const void * items,
+        nlqueue_idx n);
+
+/** @brief      Copy a number of items from queue buffer.
+ *  @notapi
+ */
+void np_lqueue_super_get_n(
+        struct nlqueue * qb,
+        const void * storage,
+        size_t item_size,
+        void * items,
+        nlqueue_idx n);
+
 /** @brief      Peek to queue head; the item is not removed from queue.
  *  @param      qb
  *              Pointer to lightweight queue base.
  *  @return     Index of the item where the queue head is located.
  *  @notapi
  */
-int_fast8_t np_lqueue_super_head(const struct nlqueue * qb);
+nlqueue_idx np_lqueue_super_head(const struct nlqueue * qb);
 
-/** @brief      Peek to queue head; the item is not removed from queue.
+/** @brief      Peek to queue tail; the item is not removed from queue.
  *  @param      qb
  *              Pointer to lightweight queue base.
  *  @return     Index of the item where the queue tail is located.
  *  @notapi
  */
-int_fast8_t np_lqueue_super_tail(const struct nlqueue * qb);
+nlqueue_idx np_lqueue_super_tail(const struct nlqueue * qb);
+
+/** @brief      Single-producer/single-consumer lightweight queue structure.
+ *
+ *  The queue can be used by exactly one producer thread and exactly one
+ *  consumer thread at the same time without a critical section. Producer and
+ *  consumer indices are placed in separate cache lines and each side writes
+ *  only its own index.
+ *
+ *  Only the producer may call @ref NLQUEUE_SPSC_IS_FULL and
+ *  @ref NLQUEUE_SPSC_PUT, and only the consumer may call
+ *  @ref NLQUEUE_SPSC_IS_EMPTY, @ref NLQUEUE_SPSC_HEAD and
+ *  @ref NLQUEUE_SPSC_GET.
+ *
+ *  @param      T
+ *              Type of items in this queue.
+ *  @param      size
+ *              Maximum number of items in queue.
+ *
+ *  @code
+ *  struct uart_queue nlqueue_spsc(uint8_t, 64);
+ *  @endcode
+ *
+ *  @note       The parameter @a size must be greater than 2.
+ *  @note       The parameter @a size must be a number which is a power of 2.
+ */
+#define nlqueue_spsc(T, size)                                               \
+    {                                                                       \
+        struct nlqueue_spsc super;                                          \
+        T np_lq_storage[(((size < 2) || !NBITS_IS_POWEROF2(size)) ?         \
+            -1 : size)];                                                    \
+    }
+
+/** @brief      One side of single-producer/single-consumer queue.
+ *  @notapi
+ */
+struct NPLATFORM_ALIGN(NARCH_CACHE_LINE, nlqueue_spsc_end)
+{
+    uint32_t                    index;  /**< Free running index of this side,
+                                         *   written only by this side.     */
+    uint32_t                    cached; /**< Last seen index of other side. */
+    uint32_t                    mask;
+};
+
+/** @brief      Single-producer/single-consumer queue base structure.
+ *  @notapi
+ */
+struct nlqueue_spsc
+{
+    struct nlqueue_spsc_end     producer;
+    struct nlqueue_spsc_end     consumer;
+};
+
+/** @brief      Initialize a single-producer/single-consumer queue.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ *  @mseffect
+ */
+#define NLQUEUE_SPSC_INIT(Q)                                                \
+        np_lqueue_spsc_init(                                                \
+                &(Q)->super,                                                \
+                NBITS_ARRAY_SIZE((Q)->np_lq_storage))
+
+/** @brief      Put an item to queue in FIFO mode, producer side.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ *  @note       Before calling this function ensure that queue is not full, see
+ *              @ref NLQUEUE_SPSC_IS_FULL.
+ *  @mseffect
+ */
+#define NLQUEUE_SPSC_PUT(Q, a_item)                                         \
+        do {                                                                \
+            (Q)->np_lq_storage[nlqueue_spsc_idx_put(&(Q)->super)] =         \
+                    (a_item);                                               \
+            nlqueue_spsc_commit_put(&(Q)->super);                           \
+        } while (0)
+
+/** @brief      Get an item from the queue buffer, consumer side.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ *  @param      a_item
+ *              An lvalue which receives the item.
+ *  @note       Before calling this function ensure that queue has an item. See
+ *              @ref NLQUEUE_SPSC_IS_EMPTY.
+ *  @mseffect
+ */
+#define NLQUEUE_SPSC_GET(Q, a_item)                                         \
+        do {                                                                \
+            (a_item) = NLQUEUE_SPSC_HEAD(Q);                                \
+            nlqueue_spsc_commit_get(&(Q)->super);                           \
+        } while (0)
+
+/** @brief      Peek to queue head, consumer side; the item is not removed
+ *              from queue.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ *  @mseffect
+ */
+#define NLQUEUE_SPSC_HEAD(Q)                                                \
+        (Q)->np_lq_storage[nlqueue_spsc_idx_get(&(Q)->super)]
+
+/** @brief      Returns the queue buffer size in number of elements.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ */
+#define NLQUEUE_SPSC_SIZE(Q)            ((Q)->super.producer.mask + 1u)
+
+/** @brief      Return true if queue is full else false, producer side.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ */
+#define NLQUEUE_SPSC_IS_FULL(Q)         nlqueue_spsc_is_full(&(Q)->super)
+
+/** @brief      Return true if queue is empty else false, consumer side.
+ *  @param      Q
+ *              Pointer to single-producer/single-consumer queue.
+ */
+#define NLQUEUE_SPSC_IS_EMPTY(Q)        nlqueue_spsc_is_empty(&(Q)->super)
+
+/** @brief      Initialise the single-producer/single-consumer queue base.
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @param      elements
+ *  @notapi
+ */
+void np_lqueue_spsc_init(struct nlqueue_spsc * qs, uint32_t elements);
+
+/** @brief      Check if the queue is full.
+ *
+ *  The consumer index is loaded only when the last seen consumer index says
+ *  that the queue is full.
+ *
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @notapi
+ */
+static inline
+bool nlqueue_spsc_is_full(struct nlqueue_spsc * qs)
+{
+    struct nlqueue_spsc_end * producer = &qs->producer;
+
+    if ((producer->index - producer->cached) > producer->mask) {
+        producer->cached = narch_atomic_load_u32(&qs->consumer.index);
+    }
+    return (producer->index - producer->cached) > producer->mask;
+}
+
+/** @brief      Check if the queue is empty.
+ *
+ *  The producer index is loaded only when the last seen producer index says
+ *  that the queue is empty.
+ *
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @notapi
+ */
+static inline
+bool nlqueue_spsc_is_empty(struct nlqueue_spsc * qs)
+{
+    struct nlqueue_spsc_end * consumer = &qs->consumer;
+
+    if (consumer->index == consumer->cached) {
+        consumer->cached = narch_atomic_load_u32(&qs->producer.index);
+    }
+    return consumer->index == consumer->cached;
+}
+
+/** @brief      Returns the index of the item where it should be put.
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @notapi
+ */
+static inline
+uint32_t nlqueue_spsc_idx_put(const struct nlqueue_spsc * qs)
+{
+    return qs->producer.index & qs->producer.mask;
+}
+
+/** @brief      Publish the item to the consumer.
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @notapi
+ */
+static inline
+void nlqueue_spsc_commit_put(struct nlqueue_spsc * qs)
+{
+    narch_atomic_store_u32(&qs->producer.index, qs->producer.index + 1u);
+}
+
+/** @brief      Returns the index of the item at the queue head.
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @notapi
+ */
+static inline
+uint32_t nlqueue_spsc_idx_get(const struct nlqueue_spsc * qs)
+{
+    return qs->consumer.index & qs->consumer.mask;
+}
+
+/** @brief      Release the item slot back to the producer.
+ *  @param      qs
+ *              Pointer to single-producer/single-consumer queue base.
+ *  @notapi
+ */
+static inline
+void nlqueue_spsc_commit_get(struct nlqueue_spsc * qs)
+{
+    narch_atomic_store_u32(&qs->consumer.index, qs->consumer.index + 1u);
+}
+
+/** @brief      Multi-producer/single-consumer lightweight queue storage.
+ *
+ *  Each item slot has a sequence number which tells whether the slot is free
+ *  or it holds an item. The sequence numbers are kept relative to the slot
+ *  index, so a zero initialized storage is an empty queue and the storage
+ *  can be statically allocated without any initialization code.
+ *
+ *  @param      T
+ *              Type of items in this queue.
+ *  @param      size
+ *              Maximum number of items in queue.
+ *
+ *  @note       The parameter @a size must be greater than 2.
+ *  @note       The parameter @a size must be a number which is a power of 2.
+ */
+#define nlqueue_mpsc_storage(T, size)                                       \
+    {                                                                       \
+        T np_lq_storage[(((size < 2) || !NBITS_IS_POWEROF2(size)) ?         \
+            -1 : size)];                                                    \
+        uint32_t np_lq_sequence[size];                                      \
+    }
+
+/** @brief      Multi-producer/single-consumer lightweight queue structure.
+ *
+ *  Any number of producers can put items into the queue without a critical
+ *  section, while exactly one consumer gets items from the queue. The queue
+ *  uses a storage defined by @ref nlqueue_mpsc_storage.
+ *
+ *  Only the consumer may call @ref NLQUEUE_MPSC_IS_EMPTY and
+ *  @ref NLQUEUE_MPSC_GET.
+ *
+ *  @param      T
+ *              Type of items in this queue.
+ */
+#define nlqueue_mpsc_dynamic(T)                                             \
+    {                                                                       \
+        struct nlqueue_mpsc super;                                          \
+        T * np_lq_storage;                                                  \
+        uint32_t * np_lq_sequence;                                          \
+    }
+
+/** @brief      One side of multi-producer/single-consumer queue.
+ *  @notapi
+ */
+struct NPLATFORM_ALIGN(NARCH_CACHE_LINE, nlqueue_mpsc_end)
+{
+    uint32_t                    index;  /**< Free running index of this side.
+                                         */
+    uint32_t                    mask;
+};
+
+/** @brief      Multi-producer/single-consumer queue base structure.
+ *  @notapi
+ */
+struct nlqueue_mpsc
+{
+    struct nlqueue_mpsc_end     producer;
+    struct nlqueue_mpsc_end     consumer;
+};
+
+/** @brief      Initialize a multi-producer/single-consumer queue.
+ *  @param      Q
+ *              Pointer to multi-producer/single-consumer queue.
+ *  @param      a_storage
+ *              Pointer to zero initialized storage.
+ *  @mseffect
+ */
+#define NLQUEUE_MPSC_INIT(Q, a_storage)                                     \
+        do {                                                                \
+            np_lqueue_mpsc_init(                                            \
+                    &(Q)->super,                                            \
+                    NBITS_ARRAY_SIZE((a_storage)->np_lq_storage));          \
+            (Q)->np_lq_storage = &(a_storage)->np_lq_storage[0];            \
+            (Q)->np_lq_sequence = &(a_storage)->np_lq_sequence[0];          \
+        } while (0)
+
+/** @brief      Put an item to queue in FIFO mode, any producer.
+ *  @param      Q
+ *              Pointer to multi-producer/single-consumer queue.
+ *  @param      a_item
+ *              Item to put.
+ *  @param      a_is_put
+ *              A boolean lvalue which is set to false when the queue is full
+ *              and the item was not put.
+ *  @mseffect
+ */
+#define NLQUEUE_MPSC_PUT(Q, a_item, a_is_put)                               \
+        do {                                                                \
+            uint32_t np_lq_position;                                        \
+                                                                            \
+            (a_is_put) = np_lqueue_mpsc_reserve(                            \
+                    &(Q)->super,                                            \
+                    (Q)->np_lq_sequence,                                    \
+                    &np_lq_position);                                       \
+            if (a_is_put) {                                                 \
+                (Q)->np_lq_storage[                                         \
+                        np_lq_position & (Q)->super.producer.mask] =        \
+                        (a_item);                                           \
+                nlqueue_mpsc_commit_put(                                    \
+                        &(Q)->super,                                        \
+                        (Q)->np_lq_sequence,                                \
+                        np_lq_position);                                    \
+            }                                                               \
+        } while (0)
+
+/** @brief      Get an item from the queue buffer, consumer side.
+ *  @param      Q
+ *              Pointer to multi-producer/single-consumer queue.
+ *  @param      a_item
+ *              An lvalue which receives the item.
+ *  @note       Before calling this function ensure that queue has an item. See
+ *              @ref NLQUEUE_MPSC_IS_EMPTY.
+ *  @mseffect
+ */
+#define NLQUEUE_MPSC_GET(Q, a_item)                                         \
+        do {                                                                \
+            (a_item) = (Q)->np_lq_storage[                                  \
+                    (Q)->super.consumer.index & (Q)->super.consumer.mask];  \
+            nlqueue_mpsc_commit_get(&(Q)->super, (Q)->np_lq_sequence);      \
+        } while (0)
+
+/** @brief      Returns the queue buffer size in number of elements.
+ *  @param      Q
+ *              Pointer to multi-producer/single-consumer queue.
+ */
+#define NLQUEUE_MPSC_SIZE(Q)            ((Q)->super.consumer.mask + 1u)
+
+/** @brief      Return true if queue is empty else false, consumer side.
+ *
+ *  A queue is also seen as empty while the producer of the oldest item has
+ *  not yet finished putting it.
+ *
+ *  @param      Q
+ *              Pointer to multi-producer/single-consumer queue.
+ */
+#define NLQUEUE_MPSC_IS_EMPTY(Q)                                            \
+        nlqueue_mpsc_is_empty(&(Q)->super, (Q)->np_lq_sequence)
+
+/** @brief      Initialise the multi-producer/single-consumer queue base.
+ *  @param      qm
+ *              Pointer to multi-producer/single-consumer queue base.
+ *  @param      elements
+ *  @notapi
+ */
+void np_lqueue_mpsc_init(struct nlqueue_mpsc * qm, uint32_t elements);
+
+/** @brief      Reserve a free slot for producer.
+ *  @param      qm
+ *              Pointer to multi-producer/single-consumer queue base.
+ *  @param      sequence
+ *              Pointer to slot sequence numbers.
+ *  @param      position
+ *              Pointer to variable which receives the reserved position.
+ *  @return     True when a slot was reserved, false when the queue is full.
+ *  @notapi
+ */
+bool np_lqueue_mpsc_reserve(
+        struct nlqueue_mpsc * qm,
+        uint32_t * sequence,
+        uint32_t * position);
+
+/** @brief      Publish the item in a reserved slot to the consumer.
+ *  @param      qm
+ *              Pointer to multi-producer/single-consumer queue base.
+ *  @param      sequence
+ *              Pointer to slot sequence numbers.
+ *  @param      position
+ *              The position returned by @ref np_lqueue_mpsc_reserve.
+ *  @notapi
+ */
+static inline
+void nlqueue_mpsc_commit_put(
+        const struct nlqueue_mpsc * qm,
+        uint32_t * sequence,
+        uint32_t position)
+{
+    narch_atomic_store_u32(&sequence[position & qm->producer.mask],
+            (position & ~qm->producer.mask) + 1u);
+}
+
+/** @brief      Check if the queue is empty.
+ *  @param      qm
+ *              Pointer to multi-producer/single-consumer queue base.
+ *  @param      sequence
+ *              Pointer to slot sequence numbers.
+ *  @notapi
+ */
+static inline
+bool nlqueue_mpsc_is_empty(const struct nlqueue_mpsc * qm, uint32_t * sequence)
+{
+    uint32_t index = qm->consumer.index;
+
+    return narch_atomic_load_u32(&sequence[index & qm->consumer.mask]) !=
+            (index & ~qm->consumer.mask) + 1u;
+}
+
+/** @brief      Release the slot at the queue head to the producers.
+ *  @param      qm
+ *              Pointer to multi-producer/single-consumer queue base.
+ *  @param      sequence
+ *              Pointer to slot sequence numbers.
+ *  @notapi
+ */
+static inline
+void nlqueue_mpsc_commit_get(struct nlqueue_mpsc * qm, uint32_t * sequence)
+{
+    uint32_t index = qm->consumer.index++;
+
+    narch_atomic_store_u32(&sequence[index & qm->consumer.mask],
+            (index & ~qm->consumer.mask) + qm->consumer.mask + 1u);
+}
+
+/** @brief      Broadcast lightweight queue structure.
+ *
+ *  One producer puts each item once and any number of readers get every item
+ *  independently. Each reader keeps its own read cursor in a
+ *  @ref nlqueue_reader structure, so adding a reader does not copy items or
+ *  change the producer side.
+ *
+ *  A gating reader holds back the producer: the queue is full while the
+ *  slowest gating reader has not yet got the oldest item. A lossy reader never
+ *  holds back the producer; when it falls behind by more than the queue size
+ *  it skips the overwritten items and counts them in its @a lost member.
+ *
+ *  Only the producer may call @ref NLQUEUE_BROADCAST_IS_FULL and
+ *  @ref NLQUEUE_BROADCAST_PUT, and only the owner of a reader may call
+ *  @ref NLQUEUE_BROADCAST_IS_EMPTY and @ref NLQUEUE_BROADCAST_GET with it.
+ *
+ *  @param      T
+ *              Type of items in this queue.
+ *  @param      size
+ *              Maximum number of items in queue.
+ *
+ *  @code
+ *  struct sensor_stream nlqueue_broadcast(struct sensor_sample, 64);
+ *  @endcode
+ *
+ *  @note       The parameter @a size must be greater than 2.
+ *  @note       The parameter @a size must be a number which is a power of 2.
+ *  @note       Lossy readers copy an item while the producer may overwrite
+ *              it, the copy is discarded when that happens. Use item types
+ *              which may be read while being written, like pointers or plain
+ *              structures.
+ */
+#define nlqueue_broadcast(T, size)                                          \
+    {                                                                       \
+        struct nlqueue_broadcast super;                                     \
+        T np_lq_storage[(((size < 2) || !NBITS_IS_POWEROF2(size)) ?         \
+            -1 : size)];                                                    \
+    }
+
+/** @brief      Broadcast queue reader.
+ *
+ *  Each reader is owned by exactly one thread or EPA.
+ */
+struct NPLATFORM_ALIGN(NARCH_CACHE_LINE, nlqueue_reader)
+{
+    uint32_t                    cursor; /**< Free running index of the next
+                                         *   item, written only by reader.  */
+    uint32_t                    lost;   /**< Number of items skipped by a
+                                         *   lossy reader.                  */
+    bool                        is_lossy;
+    struct nlqueue_reader *     next;
+};
+
+/** @brief      Broadcast queue base structure.
+ *  @notapi
+ */
+struct NPLATFORM_ALIGN(NARCH_CACHE_LINE, nlqueue_broadcast)
+{
+    uint32_t                    index;  /**< Free running index of producer,
+                                         *   written only by producer.      */
+    uint32_t                    mask;
+    uint32_t                    cached; /**< Last seen cursor of the slowest
+                                         *   gating reader.                 */
+    struct nlqueue_reader *     readers;
+};
+
+/** @brief      Initialize a broadcast queue.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ *  @mseffect
+ */
+#define NLQUEUE_BROADCAST_INIT(Q)                                           \
+        np_lqueue_broadcast_init(                                           \
+                &(Q)->super,                                                \
+                NBITS_ARRAY_SIZE((Q)->np_lq_storage))
+
+/** @brief      Subscribe a reader to a broadcast queue.
+ *
+ *  The reader gets only items put after it was subscribed.
+ *
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ *  @param      a_reader
+ *              Pointer to reader structure.
+ *  @param      a_is_lossy
+ *              When true the reader does not hold back the producer.
+ *  @note       Readers must be subscribed and unsubscribed by the producer or
+ *              while the producer does not put items.
+ *  @mseffect
+ */
+#define NLQUEUE_BROADCAST_SUBSCRIBE(Q, a_reader, a_is_lossy)                \
+        np_lqueue_broadcast_subscribe(&(Q)->super, (a_reader), (a_is_lossy))
+
+/** @brief      Unsubscribe a reader from a broadcast queue.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ *  @param      a_reader
+ *              Pointer to subscribed reader structure.
+ *  @note       See the note of @ref NLQUEUE_BROADCAST_SUBSCRIBE.
+ *  @mseffect
+ */
+#define NLQUEUE_BROADCAST_UNSUBSCRIBE(Q, a_reader)                          \
+        np_lqueue_broadcast_unsubscribe(&(Q)->super, (a_reader))
+
+/** @brief      Put an item to queue, producer side.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ *  @param      a_item
+ *              Item to put.
+ *  @param      a_is_put
+ *              A boolean lvalue which is set to false when a gating reader
+ *              has not yet got the oldest item and the item was not put.
+ *  @mseffect
+ */
+#define NLQUEUE_BROADCAST_PUT(Q, a_item, a_is_put)                          \
+        do {                                                                \
+            (a_is_put) = !nlqueue_broadcast_is_full(&(Q)->super);           \
+            if (a_is_put) {                                                 \
+                (Q)->np_lq_storage[                                         \
+                        (Q)->super.index & (Q)->super.mask] = (a_item);     \
+                nlqueue_broadcast_commit_put(&(Q)->super);                  \
+            }                                                               \
+        } while (0)
+
+/** @brief      Get an item from the queue buffer, reader side.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ *  @param      a_reader
+ *              Pointer to subscribed reader structure.
+ *  @param      a_item
+ *              An lvalue which receives the item.
+ *  @param      a_is_got
+ *              A boolean lvalue which is set to false when the reader has no
+ *              item or when the item of a lossy reader was overwritten while
+ *              being read. In the later case the next get skips the lost
+ *              items.
+ *  @mseffect
+ */
+#define NLQUEUE_BROADCAST_GET(Q, a_reader, a_item, a_is_got)                \
+        do {                                                                \
+            (a_is_got) = np_lqueue_broadcast_claim(&(Q)->super, (a_reader));\
+            if (a_is_got) {                                                 \
+                (a_item) = (Q)->np_lq_storage[                              \
+                        (a_reader)->cursor & (Q)->super.mask];              \
+                (a_is_got) = nlqueue_broadcast_commit_get(                  \
+                        &(Q)->super, (a_reader));                           \
+            }                                                               \
+        } while (0)
+
+/** @brief      Returns the queue buffer size in number of elements.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ */
+#define NLQUEUE_BROADCAST_SIZE(Q)       ((Q)->super.mask + 1u)
+
+/** @brief      Return true if queue is full else false, producer side.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ */
+#define NLQUEUE_BROADCAST_IS_FULL(Q)    nlqueue_broadcast_is_full(&(Q)->super)
+
+/** @brief      Return true if the reader has no item else false, reader side.
+ *  @param      Q
+ *              Pointer to broadcast queue.
+ *  @param      a_reader
+ *              Pointer to subscribed reader structure.
+ */
+#define NLQUEUE_BROADCAST_IS_EMPTY(Q, a_reader)                             \
+        (narch_atomic_load_u32(&(Q)->super.index) == (a_reader)->cursor)
+
+/** @brief      Initialise the broadcast queue base.
+ *  @param      qb
+ *              Pointer to broadcast queue base.
+ *  @param      elements
+ *  @notapi
+ */
+void np_lqueue_broadcast_init(struct nlqueue_broadcast * qb, uint32_t elements);
+
+/** @brief      Subscribe a reader to the broadcast queue base.
+ *  @notapi
+ */
+void np_lqueue_broadcast_subscribe(
+        struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader,
+        bool is_lossy);
+
+/** @brief      Unsubscribe a reader from the broadcast queue base.
+ *  @notapi
+ */
+void np_lqueue_broadcast_unsubscribe(
+        struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader);
+
+/** @brief      Load the cursor of the slowest gating reader.
+ *  @return     Number of items not yet got by the slowest gating reader.
+ *  @notapi
+ */
+uint32_t np_lqueue_broadcast_gate(struct nlqueue_broadcast * qb);
+
+/** @brief      Check if the reader has an item and skip overwritten items of
+ *              a lossy reader.
+ *  @notapi
+ */
+bool np_lqueue_broadcast_claim(
+        const struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader);
+
+/** @brief      Check if the queue is full.
+ *
+ *  The reader cursors are loaded only when the last seen cursor of the slowest
+ *  gating reader says that the queue is full.
+ *
+ *  @param      qb
+ *              Pointer to broadcast queue base.
+ *  @notapi
+ */
+static inline
+bool nlqueue_broadcast_is_full(struct nlqueue_broadcast * qb)
+{
+    if ((qb->index - qb->cached) > qb->mask) {
+        return np_lqueue_broadcast_gate(qb) > qb->mask;
+    }
+    return false;
+}
+
+/** @brief      Publish the item to the readers.
+ *  @param      qb
+ *              Pointer to broadcast queue base.
+ *  @notapi
+ */
+static inline
+void nlqueue_broadcast_commit_put(struct nlqueue_broadcast * qb)
+{
+    narch_atomic_store_u32(&qb->index, qb->index + 1u);
+}
+
+/** @brief      Advance the reader cursor after the item was read.
+ *
+ *  A lossy reader loads the producer index again after the item was read. If
+ *  the producer has meanwhile started to overwrite the item slot the item is
+ *  discarded.
+ *
+ *  @param      qb
+ *              Pointer to broadcast queue base.
+ *  @param      reader
+ *              Pointer to reader structure.
+ *  @return     True when the read item is valid, else false.
+ *  @notapi
+ */
+static inline
+bool nlqueue_broadcast_commit_get(
+        const struct nlqueue_broadcast * qb,
+        struct nlqueue_reader * reader)
+{
+    if (reader->is_lossy) {
+        narch_atomic_fence_acquire();
+
+        if ((narch_atomic_load_u32(&qb->index) - reader->cursor) > qb->mask) {
+            return false;
+        }
+        reader->cursor++;
+    } else {
+        narch_atomic_store_u32(&reader->cursor, reader->cursor + 1u);
+    }
+    return true;
+}
+
+#if (NCONFIG_LQUEUE_USE_WAIT == 1) || defined(__DOXYGEN__)
+/** @brief      Waitable lightweight queue structure.
+ *
+ *  The waitable queue is a @ref nlqueue_dynamic queue which may be shared by
+ *  any number of producer and consumer threads. A consumer blocks while the
+ *  queue is empty and a producer optionally blocks while the queue is full.
+ *  The queue uses a storage defined by @ref nlqueue_storage.
+ *
+ *  When no thread waits on the queue, putting and getting an item does not
+ *  call into the OS.
+ *
+ *  Since the structure begins with the same members as
+ *  @ref nlqueue_dynamic, the queue may be inspected with @ref NLQUEUE_SIZE,
+ *  @ref NLQUEUE_EMPTY, @ref NLQUEUE_IS_EMPTY and @ref NLQUEUE_IS_FULL, but
+ *  only while holding the queue lock.
+ *
+ *  @param      T
+ *              Type of items in this queue.
+ */
+#define nlqueue_wait_dynamic(T)                                             \
+    {                                                                       \
+        struct nlqueue super;                                               \
+        T * np_lq_storage;                                                  \
+        struct nlqueue_wait np_lq_wait;                                     \
+    }
+
+/** @brief      Waitable queue synchronization structure.
+ *  @notapi
+ */
+struct nlqueue_wait
+{
+    struct nos_lock             lock;
+    uint32_t                    put_sequence;   /**< Changed on put while
+                                                 *   consumers are waiting.
+                                                 */
+    uint32_t                    get_sequence;   /**< Changed on get while
+                                                 *   producers are waiting.
+                                                 */
+    uint32_t                    getters;
+    uint32_t                    putters;
+};
+
+/** @brief      Initialize a waitable queue.
+ *  @param      Q
+ *              Pointer to waitable queue.
+ *  @param      a_storage
+ *              Pointer to storage defined by @ref nlqueue_storage.
+ *  @mseffect
+ */
+#define NLQUEUE_WAIT_INIT(Q, a_storage)                                     \
+        do {                                                                \
+            NLQUEUE_INIT_DYNAMIC(                                           \
+                    Q,                                                      \
+                    sizeof((a_storage)->np_lq_storage),                     \
+                    a_storage);                                             \
+            np_lqueue_wait_init(&(Q)->np_lq_wait);                          \
+        } while (0)
+
+/** @brief      Put an item to queue in FIFO mode, block while the queue is
+ *              full.
+ *  @param      Q
+ *              Pointer to waitable queue.
+ *  @param      a_item
+ *              Item to put.
+ *  @mseffect
+ */
+#define NLQUEUE_WAIT_PUT(Q, a_item)                                         \
+        do {                                                                \
+            np_lqueue_wait_put_lock(&(Q)->np_lq_wait, &(Q)->super);         \
+            (Q)->np_lq_storage[nlqueue_super_idx_fifo(&(Q)->super)] =       \
+                    (a_item);                                               \
+            np_lqueue_wait_put_unlock(&(Q)->np_lq_wait);                    \
+        } while (0)
+
+/** @brief      Put an item to queue in FIFO mode, never block.
+ *
+ *  When the queue is full the oldest item is overwritten, the same as with
+ *  @ref NLQUEUE_PUT_FIFO.
+ *
+ *  @param      Q
+ *              Pointer to waitable queue.
+ *  @param      a_item
+ *              Item to put.
+ *  @mseffect
+ */
+#define NLQUEUE_WAIT_PUT_FIFO(Q, a_item)                                    \
+        do {                                                                \
+            nos_lock_acquire(&(Q)->np_lq_wait.lock);                        \
+            (Q)->np_lq_storage[nlqueue_super_idx_fifo(&(Q)->super)] =       \
+                    (a_item);                                               \
+            np_lqueue_wait_put_unlock(&(Q)->np_lq_wait);                    \
+        } while (0)
+
+/** @brief      Get an item from the queue buffer, block while the queue is
+ *              empty.
+ *  @param      Q
+ *              Pointer to waitable queue.
+ *  @param      a_item
+ *              An lvalue which receives the item.
+ *  @mseffect
+ */
+#define NLQUEUE_WAIT_GET(Q, a_item)                                         \
+        do {                                                                \
+            np_lqueue_wait_get_lock(&(Q)->np_lq_wait, &(Q)->super);         \
+            (a_item) = (Q)->np_lq_storage[nlqueue_super_idx_get(            \
+                    &(Q)->super)];                                          \
+            np_lqueue_wait_get_unlock(&(Q)->np_lq_wait);                    \
+        } while (0)
+
+/** @brief      Initialise the waitable queue synchronization structure.
+ *  @notapi
+ */
+void np_lqueue_wait_init(struct nlqueue_wait * qw);
+
+/** @brief      Lock the queue and wait until it has a free element.
+ *  @notapi
+ */
+void np_lqueue_wait_put_lock(struct nlqueue_wait * qw,
+        const struct nlqueue * qb);
+
+/** @brief      Unlock the queue after put and wake up a waiting consumer.
+ *  @notapi
+ */
+void np_lqueue_wait_put_unlock(struct nlqueue_wait * qw);
+
+/** @brief      Lock the queue and wait until it has an item.
+ *  @notapi
+ */
+void np_lqueue_wait_get_lock(struct nlqueue_wait * qw,
+        const struct nlqueue * qb);
+
+/** @brief      Unlock the queue after get and wake up a waiting producer.
+ *  @notapi
+ */
+void np_lqueue_wait_get_unlock(struct nlqueue_wait * qw);
+#endif /* (NCONFIG_LQUEUE_USE_WAIT == 1) */
 
 #ifdef __cplusplus
 }
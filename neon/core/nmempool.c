@@ -12,6 +12,142 @@
 #include "core/nport.h"
 #include "core/nmempool.h"
 
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1)
+#define CACHE_BATCH                     (NCONFIG_MEMPOOL_CACHE_SIZE / 2u)
+
+/** @brief      Caches attached by the current thread.
+ */
+static NPLATFORM_THREAD_LOCAL struct nmem_cache * g_local_caches;
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_LOCK_FREE == 1)
+#define POOL_INDEX_MASK                 0xffffu
+#define POOL_INDEX_NONE                 0xffffu
+#define POOL_GENERATION                 0x10000u
+
+static uint32_t * pool_element(const struct nmem_pool * pool, uint32_t index)
+{
+    return (uint32_t *)((char *)pool->storage + index * pool->element_size);
+}
+
+static uint32_t pool_index(const struct nmem_pool * pool, const void * mem)
+{
+    return (uint32_t)(((const char *)mem - (const char *)pool->storage) /
+            pool->element_size);
+}
+
+static uint32_t pool_next_head(uint32_t head, uint32_t index)
+{
+    return ((head + POOL_GENERATION) & ~POOL_INDEX_MASK) | index;
+}
+
+void nmem_pool_init(
+        struct nmem_pool * pool,
+        void * storage,
+        size_t storage_size,
+        uint32_t elements)
+{
+    pool->element_size = (uint32_t)(storage_size / elements);
+    pool->storage = storage;
+
+    /* The index POOL_INDEX_NONE terminates the free list, so the elements
+     * above it can not be addressed and are left unused.
+     */
+    if (elements > POOL_INDEX_NONE) {
+        elements = POOL_INDEX_NONE;
+    }
+    pool->free = elements;
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+    pool->head = POOL_INDEX_NONE;
+    pool->used = 0u;
+    pool->elements = elements;
+#else
+    pool->head = 0u;
+
+    for (uint32_t i = 0u; i < elements; i++) {
+        *pool_element(pool, i) = (i + 1u) < elements ? i + 1u : POOL_INDEX_NONE;
+    }
+#endif
+}
+
+/* The free counter is decremented before elements are popped and incremented
+ * after elements are pushed, so a successful decrement guarantees that the
+ * free list holds the elements for this caller.
+ */
+static uint32_t pool_get(struct nmem_pool * pool, void ** blocks, uint32_t n)
+{
+    uint32_t free;
+    uint32_t head;
+
+    do {
+        free = narch_atomic_load_u32(&pool->free);
+
+        if (free == 0u) {
+            return 0u;
+        }
+
+        if (n > free) {
+            n = free;
+        }
+    } while (!narch_atomic_cas_u32(&pool->free, free, free - n));
+
+    for (uint32_t i = 0u; i < n; i++) {
+        for (;;) {
+            uint32_t * element;
+            uint32_t next;
+
+            head = narch_atomic_load_u32(&pool->head);
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+            /* The reserved block is not in the free list, so it must be one
+             * of never used blocks.
+             */
+            if ((head & POOL_INDEX_MASK) == POOL_INDEX_NONE) {
+                uint32_t used = narch_atomic_load_u32(&pool->used);
+
+                if ((used < pool->elements) &&
+                        narch_atomic_cas_u32(&pool->used, used, used + 1u)) {
+                    blocks[i] = pool_element(pool, used);
+                    break;
+                }
+                continue;
+            }
+#endif
+            element = pool_element(pool, head & POOL_INDEX_MASK);
+            /* The element may be popped and overwritten by other thread after
+             * the head was loaded, then the compare and swap below fails.
+             */
+            next = narch_atomic_load_u32(element);
+
+            if (narch_atomic_cas_u32(&pool->head, head,
+                    pool_next_head(head, next))) {
+                blocks[i] = element;
+                break;
+            }
+        }
+    }
+    return n;
+}
+
+/* The blocks are linked into a chain first, so the whole chain is pushed with
+ * a single compare and swap.
+ */
+static void pool_put(struct nmem_pool * pool, void * const * blocks,
+        uint32_t n)
+{
+    uint32_t head;
+
+    for (uint32_t i = 1u; i < n; i++) {
+        narch_atomic_store_u32(blocks[i - 1u], pool_index(pool, blocks[i]));
+    }
+
+    do {
+        head = narch_atomic_load_u32(&pool->head);
+        narch_atomic_store_u32(blocks[n - 1u], head & POOL_INDEX_MASK);
+    } while (!narch_atomic_cas_u32(&pool->head, head,
+            pool_next_head(head, pool_index(pool, blocks[0]))));
+    narch_atomic_add_u32(&pool->free, n);
+}
+#else
 void nmem_pool_init(
         struct nmem_pool * pool,
         void * storage,
@@ -19,11 +155,15 @@ void nmem_pool_init(
         uint32_t elements)
 {
     size_t element_size = storage_size / elements;
-    char * current_element;
 
     nlist_sll_init(&pool->next);
     pool->free = elements;
-    current_element = storage;
+    pool->element_size = (uint32_t)element_size;
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+    pool->storage = storage;
+    pool->used = 0u;
+#else
+    char * current_element = storage;
 
     for (uint32_t i = 0u; i < elements; i++) {
         struct nlist_sll * current_list = (struct nlist_sll *)current_element;
@@ -31,33 +171,166 @@ void nmem_pool_init(
         nlist_sll_add_before(&pool->next, current_list);
         current_element += element_size;
     }
+#endif
 }
 
-void * nmem_pool_alloc(struct nmem_pool * pool)
+static uint32_t pool_get(struct nmem_pool * pool, void ** blocks, uint32_t n)
 {
-    void * retval = NULL;
     struct nos_critical local;
 
     nos_critical_lock(&local);
-    if (pool->free != 0u) {
-        pool->free--;
-        retval = nlist_sll_next(&pool->next);
+    if (n > pool->free) {
+        n = pool->free;
+    }
+    pool->free -= n;
+
+    for (uint32_t i = 0u; i < n; i++) {
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+        if (nlist_sll_is_empty(&pool->next)) {
+            blocks[i] = (char *)pool->storage +
+                    (size_t)pool->used++ * pool->element_size;
+            continue;
+        }
+#endif
+        blocks[i] = nlist_sll_next(&pool->next);
         nlist_sll_remove_from(&pool->next);
     }
     nos_critical_unlock(&local);
 
-    return retval;
+    return n;
 }
 
-void nmem_pool_free(struct nmem_pool * pool, void * mem)
+static void pool_put(struct nmem_pool * pool, void * const * blocks,
+        uint32_t n)
 {
-    struct nlist_sll * current = mem;
     struct nos_critical local;
 
     nos_critical_lock(&local);
-    pool->free++;
-    nlist_sll_add_before(&pool->next, current);
+    pool->free += n;
+
+    for (uint32_t i = 0u; i < n; i++) {
+        nlist_sll_add_before(&pool->next, blocks[i]);
+    }
     nos_critical_unlock(&local);
 }
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1)
+static struct nmem_cache * cache_find(const struct nmem_pool * pool)
+{
+    struct nmem_cache * cache;
+
+    for (cache = g_local_caches; cache != NULL; cache = cache->next) {
+        if (cache->pool == pool) {
+            break;
+        }
+    }
+    return cache;
+}
+
+void nmem_cache_attach(struct nmem_cache * cache, struct nmem_pool * pool)
+{
+    cache->pool = pool;
+    cache->count = 0u;
+    cache->next = g_local_caches;
+    g_local_caches = cache;
+}
+
+void nmem_cache_detach(struct nmem_cache * cache)
+{
+    struct nmem_cache ** link;
+
+    if (cache->count != 0u) {
+        pool_put(cache->pool, cache->blocks, cache->count);
+        cache->count = 0u;
+    }
+
+    for (link = &g_local_caches; *link != NULL; link = &(*link)->next) {
+        if (*link == cache) {
+            *link = cache->next;
+            break;
+        }
+    }
+}
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_MAPPED == 1)
+nerror nmem_pool_init_mapped(
+        struct nmem_pool * pool,
+        size_t element_size,
+        uint32_t elements,
+        uint32_t flags)
+{
+    void * storage;
+
+    if ((elements == 0u) || (element_size > (SIZE_MAX - NMEM_POOL_ALIGN))) {
+        return -EARG_OUTOFRANGE;
+    }
+    element_size = (element_size + NMEM_POOL_ALIGN - 1u) &
+            ~((size_t)NMEM_POOL_ALIGN - 1u);
+
+    if (element_size > (SIZE_MAX / elements)) {
+        return -EARG_OUTOFRANGE;
+    }
+    storage = nos_mem_map(element_size * elements, flags);
+
+    if (storage == NULL) {
+        return -EMEM_EXHAUSTED;
+    }
+    nmem_pool_init(pool, storage, element_size * elements, elements);
+
+    return EOK;
+}
+#endif
+
+void * nmem_pool_alloc(struct nmem_pool * pool)
+{
+    void * retval;
+
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1)
+    struct nmem_cache * cache = cache_find(pool);
+
+    if (cache != NULL) {
+        if (cache->count == 0u) {
+            cache->count = pool_get(pool, cache->blocks, CACHE_BATCH);
+
+            if (cache->count == 0u) {
+                return NULL;
+            }
+        }
+        return cache->blocks[--cache->count];
+    }
+#endif
+
+    if (pool_get(pool, &retval, 1u) == 0u) {
+        return NULL;
+    }
+    return retval;
+}
+
+void nmem_pool_free(struct nmem_pool * pool, void * mem)
+{
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1)
+    struct nmem_cache * cache = cache_find(pool);
+
+    if (cache != NULL) {
+        /* Drain the older half, the most recently freed blocks are still
+         * likely in this CPU cache.
+         */
+        if (cache->count == NCONFIG_MEMPOOL_CACHE_SIZE) {
+            pool_put(pool, cache->blocks, CACHE_BATCH);
+            cache->count -= CACHE_BATCH;
+
+            for (uint32_t i = 0u; i < cache->count; i++) {
+                cache->blocks[i] = cache->blocks[i + CACHE_BATCH];
+            }
+        }
+        cache->blocks[cache->count++] = mem;
+
+        return;
+    }
+#endif
+    pool_put(pool, &mem, 1u);
+}
 
 /** @} */
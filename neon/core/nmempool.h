@@ -19,18 +19,67 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "core/nconfig.h"
+#include "core/nport.h"
 #include "core/nlist_sll.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if (NCONFIG_MEMPOOL_USE_LOCK_FREE == 1)
+/** @brief      Lock-free memory pool structure.
+ *
+ *  The @a head holds the index of the first free element in the lower 16 bits
+ *  and a generation counter in the upper 16 bits. The generation is changed on
+ *  each update, so a compare and swap of a head which was meanwhile popped and
+ *  pushed back fails. Each free element holds the index of the next free
+ *  element.
+ */
+struct nmem_pool
+{
+    uint32_t head;
+    uint32_t free;                      /**< Never greater than the number of
+                                         *   elements in the free list.     */
+    uint32_t element_size;
+    void * storage;
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+    uint32_t used;                      /**< Number of blocks ever allocated.
+                                         */
+    uint32_t elements;
+#endif
+};
+#else
 struct nmem_pool
 {
     struct nlist_sll next;
     uint32_t free;
     uint32_t element_size;
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+    void * storage;
+    uint32_t used;                      /**< Number of blocks ever allocated.
+                                         */
+#endif
 };
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1) || defined(__DOXYGEN__)
+/** @brief      Memory pool cache structure.
+ *
+ *  A cache keeps a small stack of free blocks of one pool for one thread.
+ *  While a cache is attached, @ref nmem_pool_alloc and @ref nmem_pool_free
+ *  called by that thread take and put blocks from the cache and access the
+ *  pool only to move half of the cache at once. A block may be freed by a
+ *  thread other than the one which allocated it.
+ */
+struct nmem_cache
+{
+    struct nmem_pool * pool;
+    struct nmem_cache * next;
+    uint32_t count;
+    void * blocks[NCONFIG_MEMPOOL_CACHE_SIZE];
+};
+#endif
 
 #define npool(T, size)                                                      \
     {                                                                       \
@@ -38,6 +87,45 @@ struct nmem_pool
         T storage[size];                                                    \
     }
 
+/** @brief      Alignment of aligned memory pool elements in bytes.
+ *
+ *  See @ref NCONFIG_MEMPOOL_ALIGN.
+ */
+#if (NCONFIG_MEMPOOL_ALIGN == 0)
+#define NMEM_POOL_ALIGN                 NARCH_CACHE_LINE
+#else
+#define NMEM_POOL_ALIGN                 NCONFIG_MEMPOOL_ALIGN
+#endif
+
+/** @brief      Memory pool with elements aligned to @a a_align bytes.
+ *
+ *  Each element is padded to a multiple of @a a_align bytes, so elements
+ *  used by different CPU cores never share a cache line. The pool is
+ *  initialized with @ref NMEM_POOL_INIT.
+ *
+ *  @param      T
+ *              Type of elements in this pool.
+ *  @param      size
+ *              Number of elements in this pool.
+ *  @param      a_align
+ *              Alignment in bytes, a power of two.
+ */
+#define npool_align(T, size, a_align)                                       \
+    {                                                                       \
+        struct nmem_pool mem_pool;                                          \
+        struct NPLATFORM_ALIGN(a_align, { T np_element; }) storage[size];   \
+    }
+
+/** @brief      Memory pool with elements aligned to @ref NMEM_POOL_ALIGN
+ *              bytes.
+ *
+ *  @code
+ *  struct event_pool npool_aligned(struct sensor_event, 32);
+ *  @endcode
+ */
+#define npool_aligned(T, size)                                              \
+        npool_align(T, size, NMEM_POOL_ALIGN)
+
 #define NMEM_POOL_INIT(MP)                                                  \
     do {                                                                    \
         nmem_pool_init(                                                     \
@@ -59,6 +147,54 @@ void * nmem_pool_alloc(struct nmem_pool * pool);
 
 void   nmem_pool_free (struct nmem_pool * pool, void * mem);
 
+#if (NCONFIG_MEMPOOL_USE_MAPPED == 1) || defined(__DOXYGEN__)
+/** @brief      Initialize a memory pool with storage mapped from the OS.
+ *
+ *  The element size is rounded up to @ref NMEM_POOL_ALIGN bytes. The storage
+ *  is mapped with @ref nos_mem_map and stays mapped for the process lifetime.
+ *
+ *  @param      pool
+ *              Pointer to memory pool.
+ *  @param      element_size
+ *              Size of an element in bytes.
+ *  @param      elements
+ *              Number of elements.
+ *  @param      flags
+ *              Mapping flags, see @ref nos_mem_map.
+ *  @return     Error code.
+ *  @retval     EOK - The pool is initialized.
+ *  @retval     EARG_OUTOFRANGE - The number of elements is zero or the pool
+ *              size does not fit into @a size_t.
+ *  @retval     EMEM_EXHAUSTED - The storage could not be mapped or locked.
+ */
+nerror nmem_pool_init_mapped(
+        struct nmem_pool * pool,
+        size_t element_size,
+        uint32_t elements,
+        uint32_t flags);
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1) || defined(__DOXYGEN__)
+/** @brief      Attach a cache of the pool to the current thread.
+ *
+ *  Usually each scheduler thread attaches its cache before it starts to run
+ *  the scheduler.
+ *
+ *  @param      cache
+ *              Pointer to cache structure owned by the current thread.
+ *  @param      pool
+ *              Pointer to memory pool.
+ */
+void nmem_cache_attach(struct nmem_cache * cache, struct nmem_pool * pool);
+
+/** @brief      Return all cached blocks to the pool and detach the cache from
+ *              the current thread.
+ *  @param      cache
+ *              Pointer to cache structure attached by the current thread.
+ */
+void nmem_cache_detach(struct nmem_cache * cache);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
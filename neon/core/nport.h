@@ -16,10 +16,12 @@
 #ifndef NEON_PORT_H_
 #define NEON_PORT_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 #include "core/nconfig.h"
+#include "core/nerror.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -220,6 +222,17 @@ extern const char * const nsys_platform_version;
 #define NPLATFORM_ALIGN(a_align, a_decl)
 #endif
 
+/** @brief      Declare a variable with thread storage duration.
+ *
+ *  Each thread gets its own instance of the variable.
+ *  @hideinitializer
+ */
+#if defined(__GNUC__)
+#define NPLATFORM_THREAD_LOCAL          __thread
+#else
+#define NPLATFORM_THREAD_LOCAL
+#endif
+
 /** @brief      Returns current date.
  * 
  *  This macro will return a string containing the current date.
@@ -267,6 +280,15 @@ extern const bool narch_has_atomics;
 #if !defined(NARCH_ALIGN)
 #define NARCH_ALIGN                     NCONFIG_CPU_DATA_ALIGN
 #endif
+
+/** @brief      Size of CPU data cache line in bytes.
+ *
+ *  Data written by different CPU cores should be placed in different cache
+ *  lines. CPUs without data cache use the natural alignment.
+ */
+#if !defined(NARCH_CACHE_LINE)
+#define NARCH_CACHE_LINE                NARCH_ALIGN
+#endif
     
 /** @brief      Stop the CPU execution.
  * 
@@ -307,6 +329,101 @@ void narch_atomic_set_bit(uint32_t * u32, uint_fast8_t bit);
  */
 void narch_atomic_clear_bit(uint32_t * u32, uint_fast8_t bit);
 
+/** @brief      Atomically increment unsigned 16-bit integer variable.
+ *
+ *  The operation does not enter a critical section. Architectures with
+ *  exclusive load/store instructions implement it with a retry loop. Only
+ *  architectures which set NARCH_HAS_ATOMICS to 1 provide this function.
+ *
+ *  @param      u16
+ *              Pointer to unsigned 16-bit integer.
+ *  @return     The incremented value.
+ */
+uint_fast16_t narch_atomic_inc_u16(uint16_t * u16);
+
+/** @brief      Atomically decrement unsigned 16-bit integer variable.
+ *
+ *  All memory accesses done before the decrement are visible to the thread
+ *  which observes the decremented value.
+ *
+ *  @param      u16
+ *              Pointer to unsigned 16-bit integer.
+ *  @return     The decremented value.
+ */
+uint_fast16_t narch_atomic_dec_u16(uint16_t * u16);
+
+/** @brief      Atomically load unsigned 32-bit integer variable.
+ *
+ *  Memory accesses done after the load can not be reordered before it. All
+ *  memory accesses done by other thread before it stored the value with
+ *  @ref narch_atomic_store_u32 are visible after the load.
+ *
+ *  @param      u32
+ *              Pointer to unsigned 32-bit integer.
+ *  @return     The loaded value.
+ */
+uint32_t narch_atomic_load_u32(const uint32_t * u32);
+
+/** @brief      Atomically store unsigned 32-bit integer variable.
+ *
+ *  Memory accesses done before the store can not be reordered after it.
+ *
+ *  @param      u32
+ *              Pointer to unsigned 32-bit integer.
+ *  @param      value
+ *              Value to store.
+ */
+void narch_atomic_store_u32(uint32_t * u32, uint32_t value);
+
+/** @brief      Atomically add to unsigned 32-bit integer variable.
+ *
+ *  The operation is ordered with respect to all other memory accesses.
+ *
+ *  @param      u32
+ *              Pointer to unsigned 32-bit integer.
+ *  @param      value
+ *              Value to add.
+ *  @return     The new value.
+ */
+uint32_t narch_atomic_add_u32(uint32_t * u32, uint32_t value);
+
+/** @brief      Atomically subtract from unsigned 32-bit integer variable.
+ *
+ *  The operation is ordered with respect to all other memory accesses.
+ *
+ *  @param      u32
+ *              Pointer to unsigned 32-bit integer.
+ *  @param      value
+ *              Value to subtract.
+ *  @return     The new value.
+ */
+uint32_t narch_atomic_sub_u32(uint32_t * u32, uint32_t value);
+
+/** @brief      Order loads done before the fence with memory accesses done
+ *              after it.
+ *
+ *  Used by readers which validate plainly read data by loading a shared
+ *  variable again after reading the data.
+ */
+void narch_atomic_fence_acquire(void);
+
+/** @brief      Atomically compare and swap unsigned 32-bit integer variable.
+ *
+ *  The @a desired value is stored only when the variable holds the
+ *  @a expected value. The operation is ordered with respect to all other
+ *  memory accesses.
+ *
+ *  @param      u32
+ *              Pointer to unsigned 32-bit integer.
+ *  @param      expected
+ *              Expected current value.
+ *  @param      desired
+ *              Value to store.
+ *  @return     True when the value was stored, else false.
+ */
+bool narch_atomic_cas_u32(uint32_t * u32, uint32_t expected,
+        uint32_t desired);
+
 /** @brief      Calculate exponent of 2.
  * 
  *  @param      x
@@ -333,6 +450,10 @@ uint_fast8_t narch_log2(uint32_t x);
  *  @brief      Port Board support
  *  @{ */
 
+/** @brief      Initialize the board peripherals.
+ */
+void nboard_init(void);
+
 /** @} */
 /** @defgroup   nport_os Port OS support
  *  @brief      Port OS support
@@ -354,6 +475,131 @@ void nos_critical_lock(struct nos_critical * lock);
  */
 void nos_critical_unlock(struct nos_critical * lock);
 
+/** @brief      A lock state variable structure.
+ *
+ *  Unlike @ref nos_critical, which is a single system wide lock, each lock
+ *  instance protects only its own data. A zero initialized structure is an
+ *  unlocked lock.
+ */
+struct nos_lock
+{
+    uint32_t state;
+};
+
+/** @brief      Acquire the lock.
+ *
+ *  When the lock is not contended the function does not call into the OS.
+ */
+void nos_lock_acquire(struct nos_lock * lock);
+
+/** @brief      Release the lock.
+ */
+void nos_lock_release(struct nos_lock * lock);
+
+/** @brief      A wake-up state variable structure.
+ *
+ *  A thread waits on the wake-up object until some other thread signals it.
+ *  A signal sent while nobody is waiting is remembered, so the next wait
+ *  returns immediately. A zero initialized structure has no pending signal.
+ */
+struct nos_wakeup
+{
+    uint32_t state;
+};
+
+/** @brief      Suspend the calling thread until @a wakeup is signalled.
+ */
+void nos_wakeup_wait(struct nos_wakeup * wakeup);
+
+/** @brief      Signal the @a wakeup object.
+ *
+ *  The OS is called only when a thread is actually sleeping on the object.
+ */
+void nos_wakeup_signal(struct nos_wakeup * wakeup);
+
+/** @brief      Suspend the calling thread while @a word holds @a expected
+ *              value.
+ *
+ *  The value is compared and the thread is suspended atomically with respect
+ *  to @ref nos_word_wake, so a wake-up which follows a change of the word is
+ *  never lost. The function may return spuriously, the caller must check the
+ *  condition again. On Linux this is a futex wait.
+ */
+void nos_word_wait(uint32_t * word, uint32_t expected);
+
+/** @brief      Wake up at most @a count threads waiting on @a word.
+ */
+void nos_word_wake(uint32_t * word, uint32_t count);
+
+/** @brief      Pin the calling thread to the given CPU.
+ *  @param      cpu
+ *              CPU number, starting from zero.
+ *  @return     Error code.
+ *  @retval     EOK - The thread is pinned.
+ *  @retval     EARG_OUTOFRANGE - The CPU is not available.
+ */
+nerror nos_thread_pin(uint_fast16_t cpu);
+
+/** @brief      Back the mapping with huge pages, see @ref nos_mem_map.
+ */
+#define NOS_MEM_HUGE_PAGES              0x1u
+
+/** @brief      Lock the mapping in RAM, see @ref nos_mem_map.
+ */
+#define NOS_MEM_LOCKED                  0x2u
+
+/** @brief      Map zero filled memory for the calling process.
+ *
+ *  With @ref NOS_MEM_HUGE_PAGES the memory is mapped from reserved huge
+ *  pages. When no huge page is available, regular pages are mapped and the OS
+ *  is advised to back them with transparent huge pages.
+ *
+ *  @param      size
+ *              Size of memory in bytes.
+ *  @param      flags
+ *              A combination of @ref NOS_MEM_HUGE_PAGES and
+ *              @ref NOS_MEM_LOCKED.
+ *  @return     Pointer to page aligned memory, or NULL when the memory could
+ *              not be mapped or locked.
+ */
+void * nos_mem_map(size_t size, uint32_t flags);
+
+/** @brief      Unmap memory mapped by @ref nos_mem_map.
+ *  @param      mem
+ *              Pointer returned by @ref nos_mem_map.
+ *  @param      size
+ *              The size given to @ref nos_mem_map.
+ *  @param      flags
+ *              The flags given to @ref nos_mem_map.
+ */
+void nos_mem_unmap(void * mem, size_t size, uint32_t flags);
+
+/** @brief      Sleep without timeout, see @ref nos_idle_sleep.
+ */
+#define NOS_IDLE_FOREVER                UINT32_MAX
+
+/** @brief      Get the number of system ticks.
+ *
+ *  The ticks are counted from a monotonic clock, one tick lasts
+ *  @ref NCONFIG_SYS_TICK_US microseconds. The counter wraps around.
+ */
+uint32_t nos_tick_count(void);
+
+/** @brief      Suspend the calling thread until @ref nos_idle_wakeup is called
+ *              or until @a ticks ticks elapse.
+ *
+ *  A wake-up sent before the thread started to sleep is remembered, so the
+ *  function returns immediately. No periodic tick wakes the thread.
+ *
+ *  @param      ticks
+ *              Timeout in ticks, or @ref NOS_IDLE_FOREVER.
+ */
+void nos_idle_sleep(uint32_t ticks);
+
+/** @brief      Wake up the thread sleeping in @ref nos_idle_sleep.
+ */
+void nos_idle_wakeup(void);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -5,29 +5,28 @@
  * For license information refer to LGPL-3.0.md file at the root of this project.
  */
 /** @file
- *  @defgroup   nlqueue_impl Lightweight queue implementation
- *  @brief      Lightweight queue implementation
+ *  @defgroup   npqueue_impl Priority sorted queue implementation
+ *  @brief      Priority sorted queue implementation
  *  @{ *//*==================================================================*/
 
 #include "core/npqueue.h"
 
-static int find_priority(const struct nlist_dll * object, const void * arg)
+void npqueue_sentinel_init(struct npqueue_sentinel * sentinel)
 {
-	struct npqueue * current = npqueue_from_list(object);
-
-	if (current->priority == *(uint_fast8_t *)arg) {
-		return 1;
-	} else {
-		return 0;
-	}
+    nlist_dll_init(&sentinel->list);
+    NBITARRAY_INIT(&sentinel->bitarray);
 }
 
 void npqueue_sentinel_shift(struct npqueue_sentinel * sentinel)
 {
-    struct npqueue * next = npqueue_next(sentinel);
+    struct npqueue * head = npqueue_sentinel_head(sentinel);
+    struct npqueue * tail = sentinel->tails[head->priority];
 
-    nlist_dll_remove(&sentinel->list);
-    nlist_dll_add_before(&next->list, &sentinel->list);
+    if (tail != head) {
+        nlist_dll_remove(&head->list);
+        nlist_dll_add_before(&tail->list, &head->list);
+        sentinel->tails[head->priority] = head;
+    }
 }
 
 struct npqueue * npqueue_init(struct npqueue * node, uint_fast8_t priority)
@@ -44,13 +43,49 @@ void npqueue_term(struct npqueue * node)
     nlist_dll_init(&node->list);
 }
 
+/* The node is linked behind the last node of its own priority level, or
+ * behind the last node of the nearest higher occupied level, or at the queue
+ * head when there is no higher priority node.
+ */
 void npqueue_insert_sort(struct npqueue_sentinel * sentinel,
         struct npqueue * node)
 {
-    struct nlist_dll * current;
+    uint_fast8_t priority = node->priority;
+    struct nlist_dll * previous;
+
+    if (NBITARRAY_IS_SET(&sentinel->bitarray, priority)) {
+        previous = &sentinel->tails[priority]->list;
+    } else {
+        uint_fast8_t above;
+
+        above = NBITARRAY_LSBS_ABOVE(&sentinel->bitarray, priority);
+
+        if (above != priority) {
+            previous = &sentinel->tails[above]->list;
+        } else {
+            previous = &sentinel->list;
+        }
+        NBITARRAY_SET(&sentinel->bitarray, priority);
+    }
+    nlist_dll_add_before(previous, &node->list);
+    sentinel->tails[priority] = node;
+}
+
+void npqueue_remove(struct npqueue_sentinel * sentinel, struct npqueue * node)
+{
+    uint_fast8_t priority = node->priority;
+
+    if (sentinel->tails[priority] == node) {
+        struct nlist_dll * previous = nlist_dll_prev(&node->list);
 
-    current = nlist_dll_find(&sentinel->list, find_priority, &node->priority);
-    nlist_dll_add_after(current, &node->list);
+        if ((previous != &sentinel->list) &&
+                (npqueue_from_list(previous)->priority == priority)) {
+            sentinel->tails[priority] = npqueue_from_list(previous);
+        } else {
+            NBITARRAY_CLEAR(&sentinel->bitarray, priority);
+        }
+    }
+    nlist_dll_remove(&node->list);
 }
 
 /** @} */
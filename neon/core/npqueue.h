@@ -18,6 +18,8 @@
 
 #include <stdint.h>
 
+#include "core/nconfig.h"
+#include "core/nbitarray.h"
 #include "core/nlist_dll.h"
 #include "core/nport.h"
 
@@ -29,19 +31,30 @@ extern "C" {
  *  @brief      Priority sorted queue sentinel.
  *  @{ */
 
+struct npqueue;
+
 /** @brief      Priority sorted queue sentinel structure
+ *
+ *  The nodes are kept in a list sorted by priority, the highest priority
+ *  node is at the queue head. A bit array of occupied priorities and the last
+ *  node of each priority level make insert and remove operations take
+ *  constant time.
  */
 struct npqueue_sentinel
 {
     struct nlist_dll list;                      /**< Head of the queue. */
+    struct npqueue_bitmap nbitarray(NCONFIG_PQUEUE_PRIORITIES)
+            bitarray;                           /**< Occupied priorities. */
+    struct npqueue * tails[NCONFIG_PQUEUE_PRIORITIES];
+                                                /**< Last node of each
+                                                 *   occupied priority. */
 };
 
 /** @brief      Initialise a queue sentinel object.
- *  @param      a_sentinel
+ *  @param      sentinel
  *              Pointer to priority queue sentinel.
  */
-#define npqueue_sentinel_init(a_sentinel)                                   \
-        nlist_dll_init(&(a_sentinel)->list)
+void npqueue_sentinel_init(struct npqueue_sentinel * sentinel);
 
 /** @brief      Terminate a queue sentinel object
  *  @param      a_sentinel
@@ -59,7 +72,7 @@ struct npqueue_sentinel
  *  @mseffect
  */
 #define NPQUEUE_SENTINEL_IS_EMPTY(a_sentinel)                              	\
-        NLIST_DLL_IS_EMPTY(&(a_sentinel)->list)
+        NBITARRAY_IS_EMPTY(&(a_sentinel)->bitarray)
 
 /** @brief      Head of the queue
  *  @param      a_sentinel
@@ -69,7 +82,15 @@ struct npqueue_sentinel
 #define npqueue_sentinel_head(a_sentinel)                                	\
         npqueue_next(a_sentinel)
 
-/** @brief      Shift the sentinel through list.
+/** @brief      Shift the queue head to the end of its priority level.
+ *
+ *  The nodes of the highest priority are rotated in round-robin fashion,
+ *  while the order of other nodes is not changed.
+ *
+ *  @param      sentinel
+ *              Pointer to priority queue sentinel.
+ *  @note       Before calling this function ensure that the queue is not
+ *              empty, see @ref NPQUEUE_SENTINEL_IS_EMPTY.
  */
 void npqueue_sentinel_shift(struct npqueue_sentinel * sentinel);
 
@@ -81,8 +102,8 @@ void npqueue_sentinel_shift(struct npqueue_sentinel * sentinel);
 /** @brief      Priority sorted queue node structure.
  *
  *  Each node has a priority attribute. The attribute type is 8-bit unsigned
- *  integer. The highest priority has the value 255. The lowest priority has
- *  value 0.
+ *  integer. The highest priority has the value
+ *  @ref NCONFIG_PQUEUE_PRIORITIES - 1. The lowest priority has value 0.
  */
 struct npqueue
 {
@@ -107,8 +128,9 @@ struct npqueue
  *              Pointer to a priority sorted queue node.
  *  @param      priority
  *              An 8-bit unsigned integer number specifying this node priority.
- *              The highest priority has the value 255. The lowest priority has
- *              the value is 0.
+ *              The highest priority has the value
+ *              @ref NCONFIG_PQUEUE_PRIORITIES - 1. The lowest priority has the
+ *              value 0.
  *  @return     The pointer @a node.
  */
 struct npqueue * npqueue_init(struct npqueue * node, uint_fast8_t priority);
@@ -131,6 +153,9 @@ void npqueue_term(struct npqueue * node);
 #define npqueue_priority(a_node)        (a_node)->priority
 
 /** @brief      Set a node priority.
+ *
+ *  The node must not be in a queue while its priority is changed.
+ *
  *  @param      a_node
  *              Pointer to a node structure.
  *  @param      a_priority
@@ -151,6 +176,10 @@ void npqueue_term(struct npqueue * node);
         npqueue_from_list(nlist_dll_next(&(a_node)->list))
 
 /** @brief      Insert a node into the queue using sorting method.
+ *
+ *  The node is put behind all nodes of higher or equal priority, so the nodes
+ *  of equal priority are kept in FIFO order.
+ *
  *  @param      sentinel
  *              Pointer to a priority sorted queue sentinel.
  *  @param      node
@@ -161,19 +190,30 @@ void npqueue_insert_sort(
         struct npqueue * node);
 
 /** @brief      Insert a node into the queue using the FIFO method.
+ *
+ *  Since the nodes of equal priority are always kept in FIFO order, this is
+ *  the same as @ref npqueue_insert_sort.
+ *
  *  @param      a_sentinel
  *              Pointer to a priority sorted queue sentinel.
  *  @param      a_node
  *              Pointer to a priority sorted queue node.
  */
 #define npqueue_insert_fifo(a_sentinel, a_node)                             \
-        nlist_dll_add_after(&(a_sentinel)->list, &(a_node)->list)
+        npqueue_insert_sort((a_sentinel), (a_node))
 
 /** @brief      Remove the node from queue.
- *  @param      a_node
+ *
+ *  @note       Prior versions took only the node argument. The sentinel is
+ *              now needed to update the priority level tails.
+ *
+ *  @param      sentinel
+ *              Pointer to a priority sorted queue sentinel which holds the
+ *              node.
+ *  @param      node
  *              Pointer to a priority sorted queue node.
  */
-#define npqueue_remove(a_node)          nlist_dll_remove(&(a_node)->list)
+void npqueue_remove(struct npqueue_sentinel * sentinel, struct npqueue * node);
 
 /** @} */
 
@@ -23,16 +23,34 @@
 #include "core/nconfig.h"
 #include "core/nbitarray.h"
 #include "core/nlist_dll.h"
-#include "core/nepa.h"
+#include "core/nlqueue.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
     
 struct nscheduler_task;
+struct nscheduler_pool;
+struct nepa;
+struct nevent;
 
 typedef void (task_fn)(struct nscheduler_task *, void *);
 
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1) || defined(__DOXYGEN__)
+/** @brief      An event sent by other thread, waiting in inbound queue.
+ */
+struct nscheduler_post
+{
+    struct nepa *               epa;            /**< Receiving EPA. */
+    const struct nevent *       event;          /**< Event being sent. */
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1) || defined(__DOXYGEN__)
+    bool                        is_urgent;      /**< Event goes to the urgent
+                                                 *   lane.
+                                                 */
+#endif
+};
+#endif
+
 /** @brief		Scheduler context structure
  */
 struct nscheduler
@@ -45,21 +63,98 @@ struct nscheduler
 		bitarray;
         struct nlist_dll * levels[NCONFIG_SCHEDULER_PRIORITIES];
     }                           ready;          /**< Ready queue */
+#if (NCONFIG_SYS_EXITABLE_SCHEDULER == 1)
+    uint32_t                    should_exit;    /**< Exit request flag, set
+                                                 *   by any thread. */
+#endif
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1) || defined(__DOXYGEN__)
+    uint_fast8_t                ceiling;        /**< Only tasks with higher
+                                                 *   priority may preempt. */
+    uint_fast8_t                isr_nesting;    /**< ISR nesting level. */
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1) || defined(__DOXYGEN__)
+    bool                        is_stalled;     /**< A preempting task found
+                                                 *   its event not yet put. */
+#endif
+#endif
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1) || defined(__DOXYGEN__)
+    struct nos_wakeup           wakeup;         /**< Wakes the owner thread.*/
+    struct nos_lock             inbound_lock;   /**< Protects inbound. */
+    struct nscheduler_inbound
+        nlqueue(struct nscheduler_post, NCONFIG_SCHEDULER_INBOUND_SIZE)
+                                inbound;        /**< Events sent by other
+                                                 *   threads. */
+#endif
 };
 
+/** @brief      Scheduler task structure
+ */
 struct nscheduler_task
 {
-    struct nlist_dll queue;
-    struct nscheduler * scheduler;
-    uint_fast8_t prio;
-    task_fn * fn;
-    void * arg;
+    struct nlist_dll queue;                     /**< Ready queue level list. */
+    struct nscheduler * scheduler;              /**< Owning scheduler. */
+    uint_fast8_t prio;                          /**< Task priority. */
+    task_fn * fn;                               /**< Task function. */
+    void * arg;                                 /**< Task function argument.*/
+};
+
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1) || defined(__DOXYGEN__)
+/** @brief      Work-stealing pool worker structure
+ */
+struct nscheduler_worker
+{
+    struct nscheduler_pool *    pool;           /**< Owning pool. */
+    struct nos_wakeup           wakeup;         /**< Wakes the worker. */
+    struct nos_lock             lock;           /**< Protects ready queue. */
+    struct nscheduler_worker_queue
+        nlqueue(struct nepa *, NCONFIG_SCHEDULER_POOL_QUEUE_SIZE)
+                                ready;          /**< Ready EPAs. */
+};
+
+/** @brief      Work-stealing pool structure
+ */
+struct nscheduler_pool
+{
+    struct nscheduler_worker    workers[NCONFIG_SCHEDULER_POOL_WORKERS];
+    uint32_t                    next_worker;    /**< Worker which receives
+                                                 *   EPAs made ready by
+                                                 *   non-worker threads. */
+    uint32_t                    should_exit;    /**< Exit request flag. */
+    uint32_t                    epas;           /**< Number of registered
+                                                 *   EPAs. */
 };
+#endif
 
 #define nscheduler_current(scheduler)  (scheduler)->current
 
+/** @brief      Initialize a scheduler context structure.
+ *
+ *  The scheduler ready queue is emptied. Initialize the scheduler before any
+ *  task is initialized with it.
+ *
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
+ */
+void nscheduler_init(struct nscheduler * scheduler);
+
 bool nscheduler_is_started(struct nscheduler * scheduler);
 
+/** @brief      Initialize a task and bind it to a scheduler.
+ *
+ *  The task is initialized in blocked state.
+ *
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
+ *  @param      task
+ *              A pointer to task structure.
+ *  @param      fn
+ *              Task function which is called each time the task is selected
+ *              by the scheduler.
+ *  @param      arg
+ *              Argument passed to task function.
+ *  @param      prio
+ *              Task priority. The value must be smaller than
+ *              @ref NCONFIG_SCHEDULER_PRIORITIES.
+ */
 void nscheduler_task_init(
         struct nscheduler * scheduler, 
         struct nscheduler_task * task,
@@ -67,8 +162,27 @@ void nscheduler_task_init(
         void * arg,
         uint8_t prio);
 
+/** @brief      Put a task into scheduler ready queue.
+ *
+ *  Tasks of the same priority are executed in round-robin fashion. Calling
+ *  this function on a task which is already ready has no effect. The
+ *  function executes in constant time.
+ *
+ *  @param      task
+ *              A pointer to task structure.
+ *  @note       This function must be called from a critical section.
+ */
 void nscheduler_task_ready(struct nscheduler_task * task);
 
+/** @brief      Remove a task from scheduler ready queue.
+ *
+ *  Calling this function on a task which is already blocked has no effect.
+ *  The function executes in constant time.
+ *
+ *  @param      task
+ *              A pointer to task structure.
+ *  @note       This function must be called from a critical section.
+ */
 void nscheduler_task_block(struct nscheduler_task * task);
 
 /** @brief      Start executing Event Processing Agents
@@ -86,12 +200,140 @@ void nscheduler_task_block(struct nscheduler_task * task);
  *              loop can not be exited, in other words, the function is compiled
  *              as infinite loop.
  * 
+ *  - NCONFIG_SCHEDULER_USE_MULTICORE
+ *              When this argument is set to enabled (1) each scheduler
+ *              instance is started in its own thread. Use
+ *              @ref nos_thread_pin to pin the thread to a CPU before starting
+ *              the scheduler. The EPAs in @a epa_registry are owned by this
+ *              scheduler. Do not send events to an EPA from other threads
+ *              before its scheduler has been started.
+ * 
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
  *  @param      epa_registry
- *              A registry of EPAs that application wants to be executed.
+ *              A registry of EPAs that application wants to be executed. The
+ *              registry is terminated with NULL pointer. The system idle EPA
+ *              is added by the scheduler and must not be listed.
  */
 void nscheduler_start(
         struct nscheduler * scheduler, 
-        const struct nepa * const * epa_registry);
+        struct nepa * const * epa_registry);
+
+#if (NCONFIG_SYS_EXITABLE_SCHEDULER == 1) || defined(__DOXYGEN__)
+/** @brief      Request the scheduler to stop.
+ *
+ *  The scheduler loop is exited once the current task function returns.
+ *  This function may be called from any thread.
+ *
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
+ */
+void nscheduler_stop(struct nscheduler * scheduler);
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1) || defined(__DOXYGEN__)
+/** @brief      Run all ready tasks with priority above the current ceiling.
+ *
+ *  The tasks are run on the stack of the caller. The function does nothing
+ *  when called inside an ISR, see @ref nscheduler_isr_enter.
+ *
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
+ */
+void nscheduler_preempt(struct nscheduler * scheduler);
+
+/** @brief      Raise the priority ceiling.
+ *
+ *  While the ceiling is raised no task with priority equal to or lower than
+ *  @a ceiling can preempt the caller. Use it to protect a resource shared
+ *  between tasks by raising the ceiling to the highest priority of tasks
+ *  using the resource. The ceiling is never lowered by this function.
+ *
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
+ *  @param      ceiling
+ *              New priority ceiling.
+ *  @return     The previous ceiling, which must be passed to
+ *              @ref nscheduler_ceiling_restore.
+ */
+uint_fast8_t nscheduler_ceiling_raise(
+        struct nscheduler * scheduler,
+        uint_fast8_t ceiling);
+
+/** @brief      Restore the priority ceiling and run preempting tasks.
+ *
+ *  @param      scheduler
+ *              A pointer to scheduler context structure.
+ *  @param      ceiling
+ *              Priority ceiling returned by @ref nscheduler_ceiling_raise.
+ */
+void nscheduler_ceiling_restore(
+        struct nscheduler * scheduler,
+        uint_fast8_t ceiling);
+
+/** @brief      Notify the scheduler about ISR entry.
+ *
+ *  Events sent from ISR do not preempt the ISR, the preemption is done in
+ *  @ref nscheduler_isr_exit.
+ */
+void nscheduler_isr_enter(struct nscheduler * scheduler);
+
+/** @brief      Notify the scheduler about ISR exit.
+ *
+ *  When leaving the outermost ISR, ready tasks with priority above the
+ *  ceiling are run.
+ */
+void nscheduler_isr_exit(struct nscheduler * scheduler);
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1) || defined(__DOXYGEN__)
+/** @brief      Initialize a work-stealing pool structure.
+ *  @param      pool
+ *              A pointer to work-stealing pool structure.
+ */
+void nscheduler_pool_init(struct nscheduler_pool * pool);
+
+/** @brief      Register EPAs with the work-stealing pool.
+ *
+ *  Each EPA receives @ref NSM_INIT signal. Register the EPAs before the
+ *  workers are started.
+ *
+ *  @param      pool
+ *              A pointer to work-stealing pool structure.
+ *  @param      epa_registry
+ *              A registry of EPAs, terminated with NULL pointer.
+ *  @return     Error code.
+ *  @retval     EOK - All EPAs are registered.
+ *  @retval     EARG_OUTOFRANGE - There would be more EPAs in the pool,
+ *              counting the EPAs registered by earlier calls, than
+ *              @ref NCONFIG_SCHEDULER_POOL_QUEUE_SIZE, no EPA is registered.
+ */
+nerror nscheduler_pool_register(
+        struct nscheduler_pool * pool,
+        struct nepa * const * epa_registry);
+
+/** @brief      Execute a pool worker in the calling thread.
+ *
+ *  The function returns after @ref nscheduler_pool_stop is called. Each
+ *  worker should be executed by its own thread. Use @ref nos_thread_pin to
+ *  pin the thread to a CPU.
+ *
+ *  @param      pool
+ *              A pointer to work-stealing pool structure.
+ *  @param      worker_id
+ *              Worker number, a value smaller than
+ *              @ref NCONFIG_SCHEDULER_POOL_WORKERS.
+ */
+void nscheduler_pool_worker(
+        struct nscheduler_pool * pool,
+        uint_fast8_t worker_id);
+
+/** @brief      Request all pool workers to stop.
+ *  @param      pool
+ *              A pointer to work-stealing pool structure.
+ */
+void nscheduler_pool_stop(struct nscheduler_pool * pool);
+#endif
 
 #ifdef __cplusplus
 }
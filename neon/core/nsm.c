@@ -15,9 +15,9 @@
 #include "core/nevent.h"
 #include "core/nport.h"
 
-#define sm_event(event)                 &g_events[(event)]
+#define sm_event(event)                 nsm_signal(event)
 
-static const struct nevent g_events[] =
+const struct nevent nsm_signals[NEVENT_USER_ID] =
 {
     [NSM_SUPER] = NEVENT_INITIALIZER(NSM_SUPER),
     [NSM_ENTRY] = NEVENT_INITIALIZER(NSM_ENTRY),
@@ -61,7 +61,7 @@ void sm_init(struct nsm * sm)
     NPLATFORM_UNUSED_ARG(sm);
 }
 
-nsm_action sm_dispatch(struct nsm * sm, const struct nevent * event)
+nsm_action nsm_dispatch(struct nsm * sm, const struct nevent * event)
 {
 #if (NCONFIG_EPA_USE_HSM == 1)
 	return sm->type.dispatch(sm, event);
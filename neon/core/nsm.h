@@ -16,6 +16,9 @@
 #ifndef NEON_SM_H_
 #define NEON_SM_H_
 
+#include "core/nconfig.h"
+#include "core/nevent.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -60,6 +63,14 @@ extern "C" {
 #define nsm_transit_to(sm, state_ptr)                                       \
         ((sm)->state = (state_ptr), NP_SMP_TRANSIT_TO)
 
+/** @brief      Get a pointer to a predefined signal event.
+ *  @param      a_signal
+ *              One of the @ref nsm_event enumerators which are smaller than
+ *              @ref NEVENT_USER_ID.
+ *  @return     Pointer to a constant event instance.
+ */
+#define nsm_signal(a_signal)            (&nsm_signals[(a_signal)])
+
 /** @brief      State machine event identifications
  */
 enum nsm_event
@@ -149,6 +160,11 @@ struct nsm
     void *                      ws;             /**< Pointer to workspace. */
 };
 
+/** @brief      Predefined signal event instances.
+ *  @notapi
+ */
+extern const struct nevent nsm_signals[NEVENT_USER_ID];
+
 void sm_init(struct nsm * sm);
 
 nsm_action nsm_dispatch(struct nsm * sm, const struct nevent * event);
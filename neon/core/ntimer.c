@@ -0,0 +1,248 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+/** @file
+ *  @defgroup   ntimer_impl Timer implementation
+ *  @brief      Timer implementation.
+ *  @{ */
+
+#include "core/ntimer.h"
+#include "core/nport.h"
+#include "core/nepa.h"
+
+#define TIMER_SLOT_MASK                 (NTIMER_WHEEL_SLOTS - 1u)
+
+#define timer_from_list(a_list)                                             \
+        NPLATFORM_CONTAINER_OF(a_list, struct ntimer, list)
+
+/* Level L holds timers which expire in less than 2^(bits * (L + 1)) ticks.
+ * The slot within the level is selected by the bits of the expiry tick which
+ * belong to the level.
+ */
+static void wheel_insert(struct ntimer_wheel * wheel, struct ntimer * timer)
+{
+    uint32_t delta = timer->expires - wheel->now;
+    uint_fast8_t level = 0u;
+
+    while ((level < (NCONFIG_TIMER_WHEEL_LEVELS - 1u)) &&
+            ((delta >> (NCONFIG_TIMER_WHEEL_SLOT_BITS * (level + 1u))) != 0u)) {
+        level++;
+    }
+    nlist_dll_add_tail(
+            &wheel->slots[level][(timer->expires >>
+                    (NCONFIG_TIMER_WHEEL_SLOT_BITS * level)) & TIMER_SLOT_MASK],
+            &timer->list);
+}
+
+/* Move all timers from a higher level slot to lower levels.
+ */
+static void wheel_cascade(struct ntimer_wheel * wheel, struct nlist_dll * slot)
+{
+    struct nlist_dll * current;
+    struct nlist_dll * iterator;
+
+    for (NLIST_DLL_EACH_SAFE(current, iterator, slot)) {
+        nlist_dll_remove(current);
+        wheel_insert(wheel, timer_from_list(current));
+    }
+}
+
+/* For each level find the first non-empty slot after the current one. Level 0
+ * slot is expired and higher level slot is cascaded when all lower levels
+ * wrap around to the slot index.
+ */
+static uint32_t wheel_next(const struct ntimer_wheel * wheel)
+{
+    uint32_t next = NTIMER_INFINITE;
+
+    for (uint_fast8_t level = 0u; level < NCONFIG_TIMER_WHEEL_LEVELS; level++) {
+        uint_fast8_t shift = (uint_fast8_t)(NCONFIG_TIMER_WHEEL_SLOT_BITS * level);
+        uint32_t current = (wheel->now >> shift) & TIMER_SLOT_MASK;
+        uint32_t lower = wheel->now & ((UINT32_C(1) << shift) - 1u);
+
+        for (uint32_t distance = 1u; distance <= NTIMER_WHEEL_SLOTS; distance++) {
+            uint32_t slot = (current + distance) & TIMER_SLOT_MASK;
+
+            if (!nlist_dll_is_empty(&wheel->slots[level][slot])) {
+                uint32_t ticks = (distance << shift) - lower;
+
+                if (ticks < next) {
+                    next = ticks;
+                }
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+static uint32_t clamp_ticks(uint32_t ticks)
+{
+    if (ticks == 0u) {
+        return 1u;
+    }
+    if (ticks > NTIMER_MAX_TICKS) {
+        return NTIMER_MAX_TICKS;
+    }
+    return ticks;
+}
+
+static void timer_arm(
+        struct ntimer_wheel * wheel,
+        struct ntimer * timer,
+        uint32_t ticks,
+        uint32_t period)
+{
+    struct nos_critical local;
+
+    ticks = clamp_ticks(ticks);
+    nos_critical_lock(&local);
+
+    if (!nlist_dll_is_null(&timer->list)) {
+        nlist_dll_remove(&timer->list);
+    }
+    timer->expires = wheel->now + ticks;
+    timer->period = period;
+    wheel_insert(wheel, timer);
+    nos_critical_unlock(&local);
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1) && \
+    (NCONFIG_SCHEDULER_USE_MULTICORE == 0)
+    np_sys_timer_armed(wheel);
+#endif
+}
+
+void ntimer_wheel_init(struct ntimer_wheel * wheel)
+{
+    wheel->now = 0u;
+
+    for (uint_fast8_t level = 0u; level < NCONFIG_TIMER_WHEEL_LEVELS; level++) {
+        for (uint32_t slot = 0u; slot < NTIMER_WHEEL_SLOTS; slot++) {
+            nlist_dll_init(&wheel->slots[level][slot]);
+        }
+    }
+}
+
+void ntimer_wheel_tick(struct ntimer_wheel * wheel)
+{
+    struct nlist_dll * slot;
+    struct nos_critical local;
+
+    nos_critical_lock(&local);
+    wheel->now++;
+
+    for (uint_fast8_t level = 1u; level < NCONFIG_TIMER_WHEEL_LEVELS; level++) {
+        uint_fast8_t shift = (uint_fast8_t)(NCONFIG_TIMER_WHEEL_SLOT_BITS * level);
+
+        /* Cascade the level only when all lower levels have wrapped around.
+         */
+        if ((wheel->now & ((UINT32_C(1) << shift) - 1u)) != 0u) {
+            break;
+        }
+        wheel_cascade(wheel,
+                &wheel->slots[level][(wheel->now >> shift) & TIMER_SLOT_MASK]);
+    }
+    slot = &wheel->slots[0][wheel->now & TIMER_SLOT_MASK];
+
+    /* Signals are posted outside of critical section since sending an event
+     * to an EPA enters critical section, too.
+     */
+    while (!nlist_dll_is_empty(slot)) {
+        struct ntimer * timer = timer_from_list(nlist_dll_first(slot));
+        struct nepa * epa = timer->epa;
+        uint_fast16_t signal;
+
+        nlist_dll_remove(&timer->list);
+
+        if (timer->period != 0u) {
+            timer->expires += timer->period;
+            wheel_insert(wheel, timer);
+            signal = NSIGNAL_EVERY;
+        } else {
+            nlist_dll_term(&timer->list);
+            signal = NSIGNAL_AFTER;
+        }
+        nos_critical_unlock(&local);
+        nepa_send_signal(epa, signal);
+        nos_critical_lock(&local);
+    }
+    nos_critical_unlock(&local);
+}
+
+void ntimer_wheel_advance(struct ntimer_wheel * wheel, uint32_t ticks)
+{
+    while (ticks != 0u) {
+        struct nos_critical local;
+        uint32_t idle;
+
+        nos_critical_lock(&local);
+        idle = wheel_next(wheel) - 1u;
+
+        if (idle >= ticks) {
+            idle = ticks - 1u;
+        }
+        wheel->now += idle;
+        nos_critical_unlock(&local);
+        ticks -= idle;
+        ntimer_wheel_tick(wheel);
+        ticks--;
+    }
+}
+
+uint32_t ntimer_wheel_next(struct ntimer_wheel * wheel)
+{
+    struct nos_critical local;
+    uint32_t next;
+
+    nos_critical_lock(&local);
+    next = wheel_next(wheel);
+    nos_critical_unlock(&local);
+
+    return next;
+}
+
+void ntimer_init(struct ntimer * timer, struct nepa * epa)
+{
+    nlist_dll_term(&timer->list);
+    timer->epa = epa;
+    timer->expires = 0u;
+    timer->period = 0u;
+}
+
+void ntimer_after(
+        struct ntimer_wheel * wheel,
+        struct ntimer * timer,
+        uint32_t ticks)
+{
+    timer_arm(wheel, timer, ticks, 0u);
+}
+
+void ntimer_every(
+        struct ntimer_wheel * wheel,
+        struct ntimer * timer,
+        uint32_t ticks)
+{
+    timer_arm(wheel, timer, ticks, clamp_ticks(ticks));
+}
+
+void ntimer_cancel(struct ntimer * timer)
+{
+    struct nos_critical local;
+
+    nos_critical_lock(&local);
+
+    if (!nlist_dll_is_null(&timer->list)) {
+        nlist_dll_remove(&timer->list);
+        nlist_dll_term(&timer->list);
+    }
+    nos_critical_unlock(&local);
+}
+
+bool ntimer_is_running(const struct ntimer * timer)
+{
+    return !nlist_dll_is_null(&timer->list);
+}
+
+/** @} */
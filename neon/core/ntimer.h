@@ -0,0 +1,172 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+/** @file
+ *  @addtogroup neon
+ *  @{
+ */
+/** @defgroup   ntimer Timer
+ *  @brief      Hierarchical timing wheel
+ *
+ *  Timers post @ref NSIGNAL_AFTER (one-shot timers) or @ref NSIGNAL_EVERY
+ *  (periodic timers) signals to their owning EPA. Timers are kept in a
+ *  hierarchical timing wheel, so arming, cancelling and expiring a timer
+ *  take a constant time regardless of the number of armed timers.
+ *  @{
+ */
+
+#ifndef NEON_TIMER_H_
+#define NEON_TIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core/nconfig.h"
+#include "core/nlist_dll.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief      Number of slots in each timing wheel level.
+ */
+#define NTIMER_WHEEL_SLOTS              (1u << NCONFIG_TIMER_WHEEL_SLOT_BITS)
+
+/** @brief      The longest timeout which can be armed, in ticks.
+ */
+#define NTIMER_MAX_TICKS                                                    \
+        ((UINT32_C(1) << (NCONFIG_TIMER_WHEEL_SLOT_BITS *                   \
+                          NCONFIG_TIMER_WHEEL_LEVELS)) - 1u)
+
+/** @brief      No timer is armed in the timing wheel.
+ *
+ *  See @ref ntimer_wheel_next.
+ */
+#define NTIMER_INFINITE                 UINT32_MAX
+
+struct nepa;
+
+/** @brief      Timer instance
+ */
+struct ntimer
+{
+    struct nlist_dll            list;       /**< Timing wheel slot link.    */
+    struct nepa *               epa;        /**< EPA receiving the signal.  */
+    uint32_t                    expires;    /**< Absolute expiry tick.      */
+    uint32_t                    period;     /**< Period, 0 for one-shot.    */
+};
+
+/** @brief      Timing wheel
+ */
+struct ntimer_wheel
+{
+    uint32_t                    now;        /**< Current tick.              */
+    struct nlist_dll            slots[NCONFIG_TIMER_WHEEL_LEVELS]
+                                     [NTIMER_WHEEL_SLOTS];
+};
+
+/** @brief      Initialize a timing wheel.
+ */
+void ntimer_wheel_init(struct ntimer_wheel * wheel);
+
+/** @brief      Advance the timing wheel by one tick.
+ *
+ *  Expired timers post their signals to the owning EPAs. Periodic timers are
+ *  re-armed. Call this function from the system tick source.
+ */
+void ntimer_wheel_tick(struct ntimer_wheel * wheel);
+
+/** @brief      Advance the timing wheel by a number of ticks.
+ *
+ *  The result is the same as calling @ref ntimer_wheel_tick @a ticks times,
+ *  but ticks without any expiry or cascading work are skipped at once. This
+ *  function is used to catch up after the system was sleeping.
+ */
+void ntimer_wheel_advance(struct ntimer_wheel * wheel, uint32_t ticks);
+
+/** @brief      Get the number of ticks until the next timing wheel work.
+ *
+ *  The work is either a timer expiry or cascading of a higher level slot.
+ *  The system may sleep at most one tick less than the returned value
+ *  without delaying any timer.
+ *
+ *  @return     Number of ticks, or @ref NTIMER_INFINITE when no timer is
+ *              armed.
+ */
+uint32_t ntimer_wheel_next(struct ntimer_wheel * wheel);
+
+/** @brief      Initialize a timer.
+ *  @param      timer
+ *              Pointer to timer instance.
+ *  @param      epa
+ *              Pointer to EPA which will receive timer signals.
+ */
+void ntimer_init(struct ntimer * timer, struct nepa * epa);
+
+/** @brief      Arm a one-shot timer.
+ *
+ *  After @a ticks ticks the timer posts @ref NSIGNAL_AFTER signal. A running
+ *  timer is re-armed.
+ *
+ *  @param      wheel
+ *              Pointer to timing wheel.
+ *  @param      timer
+ *              Pointer to timer instance.
+ *  @param      ticks
+ *              Timeout in range 1 up to @ref NTIMER_MAX_TICKS. Values outside
+ *              of the range are clamped.
+ */
+void ntimer_after(
+        struct ntimer_wheel * wheel,
+        struct ntimer * timer,
+        uint32_t ticks);
+
+/** @brief      Arm a periodic timer.
+ *
+ *  Every @a ticks ticks the timer posts @ref NSIGNAL_EVERY signal. A running
+ *  timer is re-armed.
+ *
+ *  @param      wheel
+ *              Pointer to timing wheel.
+ *  @param      timer
+ *              Pointer to timer instance.
+ *  @param      ticks
+ *              Period in range 1 up to @ref NTIMER_MAX_TICKS. Values outside
+ *              of the range are clamped.
+ */
+void ntimer_every(
+        struct ntimer_wheel * wheel,
+        struct ntimer * timer,
+        uint32_t ticks);
+
+/** @brief      Cancel a timer.
+ *
+ *  @note       A signal which was already posted before the timer was
+ *              cancelled still remains in the EPA queue.
+ */
+void ntimer_cancel(struct ntimer * timer);
+
+/** @brief      Check if a timer is armed.
+ */
+bool ntimer_is_running(const struct ntimer * timer);
+
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1) && \
+    (NCONFIG_SCHEDULER_USE_MULTICORE == 0)
+/** @brief      Wake up the sleeping idle EPA when a timer of the system
+ *              timing wheel was armed.
+ *  @notapi
+ */
+void np_sys_timer_armed(struct ntimer_wheel * wheel);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+/** @} */
+
+#endif /* NEON_TIMER_H_ */
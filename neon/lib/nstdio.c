@@ -54,6 +54,18 @@ struct nstdio_buff nstdio_buff;
 #define NSTREAM_SEND_BYTE(c)			putchar(c)
 #endif
 
+/* The buffer given to NSTREAM_SEND may be reused after the call only when
+ * the stream is synchronous, UART send returns while it is still sending.
+ */
+#if !defined(NSTREAM_SEND)
+#define NSTREAM_SEND(buffer, size)		fwrite((buffer), 1u, (size), stdout)
+#define NSTREAM_SEND_IS_SYNC			1
+#endif
+
+#if !defined(NSTREAM_SEND_IS_SYNC)
+#define NSTREAM_SEND_IS_SYNC			0
+#endif
+
 #if !defined(NSTREAM_IS_INITIALIZED)
 #define NSTREAM_IS_INITIALIZED()		true
 #endif
@@ -81,12 +93,26 @@ bool nstdio_flush(struct nstdio_buff * buff)
     if (!NSTREAM_IS_INITIALIZED()) {
         return false;
     }
+#if (NSTREAM_SEND_IS_SYNC == 1)
+    /* Send the buffer directly from queue storage, the queue data wraps
+     * around at most once.
+     */
+    while (!NLQUEUE_IS_EMPTY(&buff->out)) {
+        const uint8_t * region;
+        uint_fast16_t count;
+        
+        region = NLQUEUE_GET_RESERVE(&buff->out, count);
+        NSTREAM_SEND(region, count);
+        NLQUEUE_GET_COMMIT(&buff->out, count);
+    }
+#else
     while (!NLQUEUE_IS_EMPTY(&buff->out)) {
         char c;
         
         c = NLQUEUE_GET(&buff->out);
         NSTREAM_SEND_BYTE(c);
     }
+#endif
     
     return true;
 }
@@ -21,90 +21,870 @@
  *  @brief      Event Processing Agent (EPA) implementation
  *  @{ *//*==================================================================*/
 
-#define epa_from_prio(ctx, a_prio)      (&(ctx)->mempool[(a_prio)])
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+/* Ready queue and EPA queues are accessed only by the owning scheduler
+ * thread. Other threads go through the scheduler inbound queue.
+ */
+#define schedule_lock(a_local)          NPLATFORM_UNUSED_ARG(a_local)
+#define schedule_unlock(a_local)        NPLATFORM_UNUSED_ARG(a_local)
+#else
+#define schedule_lock(a_local)          nos_critical_lock(a_local)
+#define schedule_unlock(a_local)        nos_critical_unlock(a_local)
+#endif
 
-#define prio_from_epa(a_epa)            ((a_epa)->task.prio)
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1) && \
+    (NCONFIG_SCHEDULER_USE_MULTICORE == 0)
+#define SYS_USE_TICKLESS_IDLE           1
 
-#if (NCONFIG_EPA_INSTANCES <= NBITARRAY_S_MAX_SIZE)
+/** @brief      Idle EPA is sleeping, senders need to wake it up.
+ */
+static bool g_idle_is_sleeping;
+#else
+#define SYS_USE_TICKLESS_IDLE           0
+#endif
 
-#define prio_queue_insert(a_queue, a_prio)                                  \
-        nbitarray_s_set(&(a_queue)->bitarray, (a_prio))
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+/** @brief      Scheduler executed by the current thread.
+ */
+static NPLATFORM_THREAD_LOCAL struct nscheduler * g_local_scheduler;
 
-#define prio_queue_remove(a_queue, a_prio)                                  \
-        nbitarray_s_clear(&(a_queue)->bitarray, (a_prio))
+static nerror schedule_post(
+        struct nscheduler * scheduler,
+        struct nepa * epa,
+        struct nequeue * lane,
+        const struct nevent * event);
+#endif
 
-#define prio_queue_get_highest(a_queue)                                     \
-        nbitarray_s_msbs(&(a_queue)->bitarray)
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+static nerror pool_post(
+        struct nscheduler_pool * pool,
+        struct nepa * epa,
+        struct nequeue * lane,
+        const struct nevent * event);
+#endif
 
-#define prio_queue_is_set(a_queue, a_prio)                                  \
-        nbitarray_s_is_set(&(a_queue)->bitarray, (a_prio))
+/* Keep the EPA budget in range 1 - NCONFIG_EPA_EVENT_BUDGET, since the batch
+ * storage is allocated on stack using the maximum budget.
+ */
+static void epa_budget_init(struct nepa * epa)
+{
+    if ((epa->budget == 0u) || (epa->budget > NCONFIG_EPA_EVENT_BUDGET)) {
+        epa->budget = NCONFIG_EPA_EVENT_BUDGET;
+    }
+}
 
-#else /* (NCONFIG_EPA_INSTANCES <= NBITARRAY_S_MAX_SIZE) */
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+/* An EPA without urgent lane gets an always empty lane of one element, so
+ * the dispatcher needs no extra check. Nothing is ever put into the lane, see
+ * nepa_send_event_urgent.
+ */
+static void epa_urgent_init(struct nepa * epa)
+{
+    if (epa->uqueue.np_lq_storage == NULL) {
+        np_lqueue_super_init(&epa->uqueue.super, 1u);
+    }
+}
+#else
+#define epa_urgent_init(a_epa)          NPLATFORM_UNUSED_ARG(a_epa)
+#endif
 
-#define prio_queue_insert(a_queue, a_prio)                                  \
-        nbitarray_x_set(&(a_queue)->bitarray[0], (a_prio))
+#if (NCONFIG_EPA_USE_ARENA == 1)
+/* Memory allocated by a state handler from the EPA arena lives only until the
+ * handler returns.
+ */
+static void epa_arena_reset(struct nepa * epa)
+{
+    if (epa->arena != NULL) {
+        narena_reset(epa->arena, 0u);
+    }
+}
+#else
+#define epa_arena_reset(a_epa)          NPLATFORM_UNUSED_ARG(a_epa)
+#endif
 
-#define prio_queue_remove(a_queue, a_prio)                                  \
-        nbitarray_x_clear(&(a_queue)->bitarray[0], (a_prio))
+#if (NCONFIG_EPA_USE_DEFER == 1)
+#define epa_has_recalled(a_epa)         ((a_epa)->recalled != 0u)
 
-#define prio_queue_get_highest(a_queue)                                     \
-        nbitarray_x_msbs(&(a_queue)->bitarray[0])
+/* Recalled events stay at the defer queue head until they are claimed. Only
+ * the EPA itself recalls and claims them, so no lock is needed.
+ */
+static uint_fast8_t epa_claim_recalled(
+        struct nepa * epa,
+        const struct nevent ** batch,
+        uint_fast8_t count)
+{
+    while ((count < epa->budget) && (epa->recalled != 0u)) {
+        batch[count++] = NLQUEUE_GET(&epa->dqueue);
+        epa->recalled--;
+    }
+    return count;
+}
+#else
+#define epa_has_recalled(a_epa)         false
+#define epa_claim_recalled(a_epa, a_batch, a_count)                         \
+        (NPLATFORM_UNUSED_ARG(a_batch), (a_count))
+#endif
 
-#define prio_queue_is_set(a_queue, a_prio)                                  \
-        nbitarray_x_is_set(&(a_queue)->bitarray[0], (a_prio))
-#endif /* (NCONFIG_EPA_INSTANCES <= NBITARRAY_S_MAX_SIZE) */
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+#define epa_is_idle(a_epa)                                                  \
+        ((narch_atomic_load_u32(&(a_epa)->pending) == 0u) &&                \
+         !epa_has_recalled(a_epa))
 
-static void task_init(struct ntask * task, uint_fast8_t prio)
+/* Claim a batch of events, recalled events first. Only the EPA itself claims
+ * events, so no lock is needed. The batch may be empty when the sender of the
+ * oldest event has not finished putting it into the queue.
+ */
+static uint_fast8_t epa_claim(
+        struct nepa * epa,
+        const struct nevent ** batch)
 {
-    task->prio = prio;
+    uint_fast8_t count;
+    uint_fast8_t queued;
+
+    count = epa_claim_recalled(epa, batch, 0u);
+    queued = count;
+
+    while ((count < epa->budget) && !NLQUEUE_MPSC_IS_EMPTY(&epa->equeue)) {
+        NLQUEUE_MPSC_GET(&epa->equeue, batch[count]);
+        count++;
+    }
+
+    if (count != queued) {
+        (void)narch_atomic_sub_u32(&epa->pending, count - queued);
+    }
+    return count;
+}
+#else
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+#define epa_is_idle(a_epa)                                                  \
+        (NLQUEUE_IS_EMPTY(&(a_epa)->uqueue) &&                              \
+         NLQUEUE_IS_EMPTY(&(a_epa)->equeue) && !epa_has_recalled(a_epa))
+#else
+#define epa_is_idle(a_epa)                                                  \
+        (NLQUEUE_IS_EMPTY(&(a_epa)->equeue) && !epa_has_recalled(a_epa))
+#endif
+
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+/* Claim a batch of events, urgent events first and then recalled events. The
+ * EPA must not be idle and the caller must hold the lock which protects the
+ * queues.
+ */
+static uint_fast8_t epa_claim(
+        struct nepa * epa,
+        const struct nevent ** batch)
+{
+    uint_fast8_t count = 0u;
+
+    while ((count < epa->budget) && !NLQUEUE_IS_EMPTY(&epa->uqueue)) {
+        batch[count++] = NLQUEUE_GET(&epa->uqueue);
+    }
+    count = epa_claim_recalled(epa, batch, count);
+
+    while ((count < epa->budget) && !NLQUEUE_IS_EMPTY(&epa->equeue)) {
+        batch[count++] = NLQUEUE_GET(&epa->equeue);
+    }
+    return count;
+}
+#else
+/* Claim a batch of events from EPA queue, recalled events first. The EPA must
+ * not be idle and the caller must hold the lock which protects the queue.
+ */
+static uint_fast8_t epa_claim(
+        struct nepa * epa,
+        const struct nevent ** batch)
+{
+    uint_fast8_t count;
+
+    count = epa_claim_recalled(epa, batch, 0u);
+
+    while ((count < epa->budget) && !NLQUEUE_IS_EMPTY(&epa->equeue)) {
+        batch[count++] = NLQUEUE_GET(&epa->equeue);
+    }
+    return count;
+}
+#endif
+#endif
+
+static void epa_dispatch_batch(
+        struct nepa * epa,
+        const struct nevent * const * batch,
+        uint_fast8_t count)
+{
+    for (uint_fast8_t i = 0u; i < count; i++) {
+        nsm_dispatch(&epa->sm, batch[i]);
+        epa_arena_reset(epa);
+        nevent_delete(batch[i]);
+    }
+}
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+/* The EPA is blocked only when it has no pending events while the lock is
+ * held. A sender which puts the first pending event takes the lock to make
+ * the EPA ready again, so no event is left behind. The check is done after
+ * the batch is dispatched, so events recalled during dispatch are seen.
+ */
+static void epa_dispatch(struct nscheduler_task * task, void * arg)
+{
+    struct nepa * epa = arg;
+    const struct nevent * batch[NCONFIG_EPA_EVENT_BUDGET];
+    uint_fast8_t count;
+    struct nos_critical local;
+
+    count = epa_claim(epa, batch);
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+    /* The EPA is pending, but the producer of the oldest event was preempted
+     * before it finished the put. Tell the preempting loop to return, so the
+     * producer can finish. The EPA stays ready.
+     */
+    if (count == 0u) {
+        epa->scheduler->is_stalled = true;
+    }
+#endif
+    epa_dispatch_batch(epa, batch, count);
+
+    if (epa_is_idle(epa)) {
+        schedule_lock(&local);
+
+        if (epa_is_idle(epa)) {
+            nscheduler_task_block(task);
+        }
+        schedule_unlock(&local);
+    }
+}
+#else
+static void epa_dispatch(struct nscheduler_task * task, void * arg)
+{
+    struct nepa * epa = arg;
+    const struct nevent * batch[NCONFIG_EPA_EVENT_BUDGET];
+    uint_fast8_t count;
+    struct nos_critical local;
+
+    schedule_lock(&local);
+    count = epa_claim(epa, batch);
+
+    if (epa_is_idle(epa)) {
+        nscheduler_task_block(task);
+    }
+    schedule_unlock(&local);
+    epa_dispatch_batch(epa, batch, count);
 }
+#endif
 
-static void equeue_init(struct nequeue * equeue)
+static void epa_init(struct nepa * epa, struct nscheduler * scheduler)
 {
-    NPLATFORM_UNUSED_ARG(equeue);
+    epa->scheduler = scheduler;
+    epa_budget_init(epa);
+    epa_urgent_init(epa);
+    nscheduler_task_init(scheduler, &epa->task, epa_dispatch, epa,
+            epa->task.prio);
+    nepa_send_signal(epa, NSM_INIT);
 }
 
 nerror nepa_send_signal(struct nepa * epa, uint_fast16_t signal)
 {
-    return nepa_send_event(epa, &g_events[signal]);
+    return nepa_send_event(epa, nsm_signal(signal));
 }
 
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+/* Put an event into the EPA queue without a lock. The event reference is
+ * taken before the EPA can see the event. The is_first is set when the EPA
+ * had no pending events, then the caller has to make the EPA ready.
+ */
+static nerror epa_enqueue(
+        struct nepa * epa,
+        const struct nevent * event,
+        bool * is_first)
+{
+    bool is_put;
+
+    nevent_ref_up(event);
+    NLQUEUE_MPSC_PUT(&epa->equeue, event, is_put);
+
+    if (!is_put) {
+        /* Undo the nevent_ref_up step from above.
+         */
+        nevent_ref_down(event);
+        *is_first = false;
+
+        return -EOBJ_INVALID;
+    }
+    *is_first = (narch_atomic_add_u32(&epa->pending, 1u) == 1u);
+
+    return EOK;
+}
+
+#if (NCONFIG_EPA_USE_PUBSUB == 1)
+/* Put an event into the EPA queue and make the EPA ready. Must be called with
+ * schedule lock held.
+ */
+static nerror epa_put(struct nepa * epa, const struct nevent * event)
+{
+    nerror error;
+    bool is_first;
+
+    error = epa_enqueue(epa, event, &is_first);
+
+    if (is_first) {
+        nscheduler_task_ready(&epa->task);
+    }
+    return error;
+}
+#endif
+#else
+/* Put an event into an EPA queue lane and make the EPA ready. Must be called
+ * with schedule lock held.
+ */
+static nerror epa_put_lane(
+        struct nepa * epa,
+        struct nequeue * lane,
+        const struct nevent * event)
+{
+    if (NLQUEUE_IS_FULL(lane)) {
+        return -EOBJ_INVALID;
+    }
+    nevent_ref_up(event);
+    NLQUEUE_PUT_FIFO(lane, event);
+    nscheduler_task_ready(&epa->task);
+
+    return EOK;
+}
+
+#define epa_put(a_epa, a_event)                                             \
+        epa_put_lane((a_epa), &(a_epa)->equeue, (a_event))
+#endif
+
+#if (SYS_USE_TICKLESS_IDLE == 1)
+/* Must be called with schedule lock held. Returns true when the sender has
+ * to wake up the sleeping idle EPA.
+ */
+static bool idle_claim_wakeup(void)
+{
+    bool should_wakeup = g_idle_is_sleeping;
+
+    g_idle_is_sleeping = false;
+
+    return should_wakeup;
+}
+#else
+#define idle_claim_wakeup()             false
+#endif
+
+/* Notify the scheduler about new ready EPAs, called after schedule lock is
+ * released.
+ */
+static void schedule_notify(struct nscheduler * scheduler, bool should_wakeup)
+{
+#if (SYS_USE_TICKLESS_IDLE == 1)
+    if (should_wakeup) {
+        nos_idle_wakeup();
+    }
+#else
+    NPLATFORM_UNUSED_ARG(should_wakeup);
+#endif
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+    nscheduler_preempt(scheduler);
+#else
+    NPLATFORM_UNUSED_ARG(scheduler);
+#endif
+}
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
 nerror nepa_send_event(struct nepa * epa, const struct nevent * event)
 {
     struct nos_critical local;
-    int_fast8_t idx;
+    bool should_wakeup;
+    bool is_first;
     nerror error;
 
-    event_ref_up(event);
-    NOS_CRITICAL_LOCK(&local);
-    idx = NLQUEUE_IDX_FIFO(&epa->equeue);
+    /* Only the sender of the first pending event enters the critical section.
+     */
+    error = epa_enqueue(epa, event, &is_first);
 
-    if (idx >= 0) {
-        NLQUEUE_IDX_REFERENCE(&epa->equeue, idx) = event;
-        //prio_queue_insert(&epa->scheduler->ready, prio_from_epa(epa));
-        NOS_CRITICAL_UNLOCK(&local);
-        error = EOK;
-    } else {
-        NOS_CRITICAL_UNLOCK(&local);
-        /* Undo the event_ref_up step from above.
-         */
-        event_ref_down(event);
-        error = -EOBJ_INVALID;
+    if (!is_first) {
+        return error;
+    }
+    schedule_lock(&local);
+    nscheduler_task_ready(&epa->task);
+    should_wakeup = idle_claim_wakeup();
+    schedule_unlock(&local);
+    schedule_notify(epa->scheduler, should_wakeup);
+
+    return EOK;
+}
+#else
+static nerror epa_send(
+        struct nepa * epa,
+        struct nequeue * lane,
+        const struct nevent * event)
+{
+    struct nos_critical local;
+    nerror error;
+    bool should_wakeup;
+
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+    if (epa->pool.pool != NULL) {
+        return pool_post(epa->pool.pool, epa, lane, event);
+    }
+#endif
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+    if (epa->scheduler != g_local_scheduler) {
+        return schedule_post(epa->scheduler, epa, lane, event);
+    }
+#endif
+    schedule_lock(&local);
+    error = epa_put_lane(epa, lane, event);
+    should_wakeup = (error == EOK) && idle_claim_wakeup();
+    schedule_unlock(&local);
+
+    if (error == EOK) {
+        schedule_notify(epa->scheduler, should_wakeup);
+    }
+    return error;
+}
+
+nerror nepa_send_event(struct nepa * epa, const struct nevent * event)
+{
+    return epa_send(epa, &epa->equeue, event);
+}
+
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+nerror nepa_send_signal_urgent(struct nepa * epa, uint_fast16_t signal)
+{
+    return nepa_send_event_urgent(epa, nsm_signal(signal));
+}
+
+nerror nepa_send_event_urgent(struct nepa * epa, const struct nevent * event)
+{
+    nerror error;
+
+    if (epa->uqueue.np_lq_storage == NULL) {
+        return -EOBJ_INVALID;
+    }
+    error = epa_send(epa, &epa->uqueue, event);
+
+    if (error != EOK) {
+        (void)narch_atomic_add_u32(&epa->uoverflows, 1u);
+    }
+    return error;
+}
+#endif
+#endif
+
+#if (NCONFIG_EPA_USE_DEFER == 1)
+/* The defer queue is accessed only by the EPA itself, so it needs no lock.
+ */
+nerror nepa_defer(struct nepa * epa, const struct nevent * event)
+{
+    if (NLQUEUE_IS_FULL(&epa->dqueue)) {
+        return -EOBJ_INVALID;
+    }
+    nevent_ref_up(event);
+    NLQUEUE_PUT_FIFO(&epa->dqueue, event);
+
+    return EOK;
+}
+
+/* Recalled events stay at the defer queue head and they are claimed before
+ * the events in the event queue, in the order they were deferred. The EPA is
+ * not blocked while it has recalled events, see epa_dispatch.
+ */
+nerror nepa_recall(struct nepa * epa)
+{
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 0)
+    struct nos_critical local;
+#endif
+
+    if ((epa->dqueue.np_lq_storage == NULL) ||
+            (epa->recalled == (NLQUEUE_SIZE(&epa->dqueue) -
+                    NLQUEUE_EMPTY(&epa->dqueue)))) {
+        return -EOBJ_INVALID;
+    }
+    epa->recalled++;
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 0)
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+    /* The EPA is being executed by a pool worker which reschedules it when
+     * it is not idle.
+     */
+    if (epa->pool.pool != NULL) {
+        return EOK;
+    }
+#endif
+    /* The EPA was blocked when it claimed the last queued event.
+     */
+    schedule_lock(&local);
+    nscheduler_task_ready(&epa->task);
+    schedule_unlock(&local);
+#endif
+
+    return EOK;
+}
+#endif
+
+#if (NCONFIG_EPA_USE_PUBSUB == 1)
+/** @brief      Subscriber priorities of each signal.
+ */
+static struct nepa_subscribers nbitarray(NCONFIG_SCHEDULER_PRIORITIES)
+        g_subscribers[NCONFIG_EPA_PUBSUB_SIGNALS];
+
+/** @brief      Subscribed EPAs indexed by their priority, EPAs of the same
+ *              priority are linked by their subscriber_next member.
+ */
+static struct nepa * g_subscriber_epas[NCONFIG_SCHEDULER_PRIORITIES];
+
+/** @brief      Number of publishers which walk the subscriber lists outside
+ *              of the critical section.
+ */
+static uint32_t g_publishers;
+
+/** @brief      Priorities whose lists hold EPAs without any subscribed signal.
+ */
+static struct nepa_subscribers g_stale_subscribers;
+
+/* Unlink the EPAs without any subscribed signal. Must be called with the
+ * critical section locked and only when no publisher walks the lists.
+ */
+static void subscribers_prune(uint_fast8_t prio)
+{
+    struct nepa ** link = &g_subscriber_epas[prio];
+
+    while (*link != NULL) {
+        struct nepa * subscriber = *link;
+
+        if (NBITARRAY_IS_EMPTY(&subscriber->signals)) {
+            *link = subscriber->subscriber_next;
+            subscriber->is_subscriber = false;
+        } else {
+            link = &subscriber->subscriber_next;
+        }
+    }
+    NBITARRAY_CLEAR(&g_stale_subscribers, prio);
+}
+
+nerror nepa_subscribe(struct nepa * epa, uint_fast16_t signal)
+{
+    struct nos_critical local;
+
+    if (signal >= NCONFIG_EPA_PUBSUB_SIGNALS) {
+        return -EARG_OUTOFRANGE;
+    }
+    nos_critical_lock(&local);
+
+    /* An EPA which has unsubscribed from all signals may still be linked,
+     * while a publisher walks the list.
+     */
+    if (!epa->is_subscriber) {
+        epa->subscriber_next = g_subscriber_epas[epa->task.prio];
+        epa->is_subscriber = true;
+        g_subscriber_epas[epa->task.prio] = epa;
+    }
+    NBITARRAY_SET(&epa->signals, (uint_fast8_t)signal);
+    NBITARRAY_SET(&g_subscribers[signal], epa->task.prio);
+    nos_critical_unlock(&local);
+
+    return EOK;
+}
+
+/* The EPA leaves the priority list when it has no subscribed signal left, and
+ * the priority leaves the signal subscribers when no EPA of the priority is
+ * subscribed to the signal anymore. While publishers walk the lists the EPA
+ * stays linked, the last publisher unlinks it, see nepa_publish.
+ */
+nerror nepa_unsubscribe(struct nepa * epa, uint_fast16_t signal)
+{
+    struct nos_critical local;
+
+    if (signal >= NCONFIG_EPA_PUBSUB_SIGNALS) {
+        return -EARG_OUTOFRANGE;
     }
-    
+    nos_critical_lock(&local);
+
+    if (NBITARRAY_IS_SET(&epa->signals, (uint_fast8_t)signal)) {
+        bool is_subscribed = false;
+
+        NBITARRAY_CLEAR(&epa->signals, (uint_fast8_t)signal);
+
+        if (NBITARRAY_IS_EMPTY(&epa->signals)) {
+            NBITARRAY_SET(&g_stale_subscribers, epa->task.prio);
+
+            if (g_publishers == 0u) {
+                subscribers_prune(epa->task.prio);
+            }
+        }
+
+        for (struct nepa * subscriber = g_subscriber_epas[epa->task.prio];
+                subscriber != NULL; subscriber = subscriber->subscriber_next) {
+            if (NBITARRAY_IS_SET(&subscriber->signals, (uint_fast8_t)signal)) {
+                is_subscribed = true;
+                break;
+            }
+        }
+
+        if (!is_subscribed) {
+            NBITARRAY_CLEAR(&g_subscribers[signal], epa->task.prio);
+        }
+    }
+    nos_critical_unlock(&local);
+
+    return EOK;
+}
+
+nerror nepa_publish_signal(uint_fast16_t signal)
+{
+    return nepa_publish(nsm_signal(signal));
+}
+
+/* The event is held by the publisher while it is being delivered, so a
+ * dynamic event without any subscriber is deleted at the end. Each
+ * subscriber gets a reference to the same event instance.
+ */
+nerror nepa_publish(const struct nevent * event)
+{
+    struct nos_critical local;
+    struct nepa_subscribers pending;
+    nerror error = EOK;
+
+    if (event->id >= NCONFIG_EPA_PUBSUB_SIGNALS) {
+        return -EARG_OUTOFRANGE;
+    }
+    nevent_ref_up(event);
+    nos_critical_lock(&local);
+    pending = g_subscribers[event->id];
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1) || \
+    (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+    /* Subscribers may belong to other threads, deliver one by one outside of
+     * the critical section. While g_publishers is not zero no EPA is
+     * unlinked, and new EPAs are linked only at the list head, so the walk
+     * visits each EPA at most once and no EPA which stays subscribed is
+     * skipped.
+     */
+    g_publishers++;
+
+    while (!NBITARRAY_IS_EMPTY(&pending)) {
+        uint_fast8_t prio = NBITARRAY_MSBS(&pending);
+
+        NBITARRAY_CLEAR(&pending, prio);
+
+        for (struct nepa * epa = g_subscriber_epas[prio]; epa != NULL;
+                epa = epa->subscriber_next) {
+            if (NBITARRAY_IS_SET(&epa->signals, (uint_fast8_t)event->id)) {
+                nos_critical_unlock(&local);
+
+                if (nepa_send_event(epa, event) != EOK) {
+                    error = -EOBJ_INVALID;
+                }
+                nos_critical_lock(&local);
+            }
+        }
+    }
+
+    if (--g_publishers == 0u) {
+        while (!NBITARRAY_IS_EMPTY(&g_stale_subscribers)) {
+            subscribers_prune(NBITARRAY_MSBS(&g_stale_subscribers));
+        }
+    }
+    nos_critical_unlock(&local);
+#else
+    struct nscheduler * scheduler = NULL;
+    bool should_wakeup;
+
+    /* Deliver to all subscribers within a single critical section, starting
+     * from the highest priority one.
+     */
+    while (!NBITARRAY_IS_EMPTY(&pending)) {
+        uint_fast8_t prio = NBITARRAY_MSBS(&pending);
+
+        NBITARRAY_CLEAR(&pending, prio);
+
+        for (struct nepa * epa = g_subscriber_epas[prio]; epa != NULL;
+                epa = epa->subscriber_next) {
+            if (!NBITARRAY_IS_SET(&epa->signals, (uint_fast8_t)event->id)) {
+                continue;
+            }
+
+            if (epa_put(epa, event) == EOK) {
+                scheduler = epa->scheduler;
+            } else {
+                error = -EOBJ_INVALID;
+            }
+        }
+    }
+    should_wakeup = (scheduler != NULL) && idle_claim_wakeup();
+    nos_critical_unlock(&local);
+
+    if (scheduler != NULL) {
+        schedule_notify(scheduler, should_wakeup);
+    }
+#endif
+    nevent_delete(event);
+
     return error;
 }
+#endif
 
 /** @} *//*==================================================================*/
 /** @defgroup   nscheduler_impl Scheduler implementation
  *  @brief      Scheduler implementation
  *  @{ *//*==================================================================*/
 
+#define task_from_queue(a_queue)                                            \
+        NPLATFORM_CONTAINER_OF((a_queue), struct nscheduler_task, queue)
+
+#if (NCONFIG_SYS_EXITABLE_SCHEDULER == 1)
+#define schedule_should_run(a_scheduler)                                    \
+        (narch_atomic_load_u32(&(a_scheduler)->should_exit) == 0u)
+#else
+#define schedule_should_run(a_scheduler)    true
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 0)
+static void idle_dispatch(struct nscheduler_task * task, void * arg);
+#endif
+
+#if (SYS_USE_TICKLESS_IDLE == 1)
+static void idle_initialize_timer(void);
+static void idle_update_timer(void);
+#endif
+
 static void schedule_initialize_epas(
-        struct nscheduler * schedule, 
-        const struct nepa * const * epa_registry)
+        struct nscheduler * scheduler, 
+        struct nepa * const * epa_registry)
+{
+    while (*epa_registry != NULL) {
+        epa_init(*epa_registry, scheduler);
+        epa_registry++;
+    }
+}
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 0)
+/* The idle EPA task is never blocked. It is always ready at the lowest
+ * priority level so the ready queue is never empty once the scheduler is
+ * started.
+ */
+static void schedule_initialize_idle(struct nscheduler * scheduler)
 {
-   
+    struct nos_critical local;
+
+    nsys_epa_idle.scheduler = scheduler;
+    nscheduler_task_init(scheduler, &nsys_epa_idle.task, idle_dispatch,
+            &nsys_epa_idle, NEPA_PRIO_MIN);
+#if (SYS_USE_TICKLESS_IDLE == 1)
+    idle_initialize_timer();
+#endif
+    schedule_lock(&local);
+    nscheduler_task_ready(&nsys_epa_idle.task);
+    schedule_unlock(&local);
+}
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+static nerror schedule_post(
+        struct nscheduler * scheduler,
+        struct nepa * epa,
+        struct nequeue * lane,
+        const struct nevent * event)
+{
+    nerror error;
+
+    nevent_ref_up(event);
+    nos_lock_acquire(&scheduler->inbound_lock);
+
+    if (!NLQUEUE_IS_FULL(&scheduler->inbound)) {
+        struct nscheduler_post * post;
+
+        post = &NLQUEUE_IDX_REFERENCE(&scheduler->inbound,
+                NLQUEUE_IDX_FIFO(&scheduler->inbound));
+        post->epa = epa;
+        post->event = event;
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+        post->is_urgent = (lane != &epa->equeue);
+#else
+        NPLATFORM_UNUSED_ARG(lane);
+#endif
+        error = EOK;
+    } else {
+        error = -EOBJ_INVALID;
+    }
+    nos_lock_release(&scheduler->inbound_lock);
+
+    if (error == EOK) {
+        nos_wakeup_signal(&scheduler->wakeup);
+    } else {
+        /* Undo the nevent_ref_up step from above.
+         */
+        nevent_ref_down(event);
+    }
+    return error;
+}
+
+/* Move the events from inbound queue into EPA queues. When an EPA queue is
+ * full the remaining events are left in inbound queue and are delivered
+ * after the EPA has processed some of its events.
+ */
+static void schedule_drain_inbound(struct nscheduler * scheduler)
+{
+    nos_lock_acquire(&scheduler->inbound_lock);
+
+    while (!NLQUEUE_IS_EMPTY(&scheduler->inbound)) {
+        struct nscheduler_post * post = &NLQUEUE_HEAD(&scheduler->inbound);
+        struct nequeue * lane = &post->epa->equeue;
+
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+        if (post->is_urgent) {
+            lane = &post->epa->uqueue;
+        }
+#endif
+        if (NLQUEUE_IS_FULL(lane)) {
+            break;
+        }
+        NLQUEUE_PUT_FIFO(lane, post->event);
+        nscheduler_task_ready(&post->epa->task);
+        (void)NLQUEUE_IDX_GET(&scheduler->inbound);
+    }
+    nos_lock_release(&scheduler->inbound_lock);
+}
+#endif
+
+/* Select the highest priority ready task. The level list head is advanced to
+ * the next task of the same priority so the tasks of equal priority are
+ * executed in round-robin fashion.
+ */
+static struct nscheduler_task * schedule_next(struct nscheduler_queue * ready)
+{
+    uint_fast8_t prio;
+    struct nlist_dll * head;
+
+    prio = NBITARRAY_MSBS(&ready->bitarray);
+    head = ready->levels[prio];
+    ready->levels[prio] = nlist_dll_next(head);
+
+    return task_from_queue(head);
+}
+
+void nscheduler_init(struct nscheduler * scheduler)
+{
+    scheduler->current = NULL;
+    NBITARRAY_INIT(&scheduler->ready.bitarray);
+
+    for (uint_fast8_t i = 0u; i < NCONFIG_SCHEDULER_PRIORITIES; i++) {
+        scheduler->ready.levels[i] = NULL;
+    }
+#if (NCONFIG_SYS_EXITABLE_SCHEDULER == 1)
+    scheduler->should_exit = 0u;
+#endif
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+    /* No preemption is possible until the scheduler is started.
+     */
+    scheduler->ceiling = NCONFIG_SCHEDULER_PRIORITIES;
+    scheduler->isr_nesting = 0u;
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+    scheduler->is_stalled = false;
+#endif
+#endif
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+    scheduler->wakeup.state = 0u;
+    scheduler->inbound_lock.state = 0u;
+    NLQUEUE_INIT(&scheduler->inbound);
+#endif
 }
 
 bool nscheduler_is_started(struct nscheduler * scheduler)
@@ -119,32 +899,425 @@ void nscheduler_task_init(
         void * arg,
         uint8_t prio)
 {
+    nlist_dll_init(&task->queue);
+    task->scheduler = scheduler;
+    task->prio = prio;
+    task->fn = fn;
+    task->arg = arg;
 }
 
 void nscheduler_task_ready(struct nscheduler_task * task)
 {
+    struct nscheduler_queue * ready = &task->scheduler->ready;
+    struct nlist_dll ** level = &ready->levels[task->prio];
 
+    if (*level == NULL) {
+        *level = &task->queue;
+        NBITARRAY_SET(&ready->bitarray, task->prio);
+    } else if (nlist_dll_is_empty(&task->queue) && (*level != &task->queue)) {
+        /* Add the task at the tail of the level list.
+         */
+        nlist_dll_add_after(*level, &task->queue);
+    }
 }
 
 void nscheduler_task_block(struct nscheduler_task * task)
 {
+    struct nscheduler_queue * ready = &task->scheduler->ready;
+    struct nlist_dll ** level = &ready->levels[task->prio];
 
+    if (!nlist_dll_is_empty(&task->queue)) {
+        if (*level == &task->queue) {
+            *level = nlist_dll_next(&task->queue);
+        }
+        nlist_dll_remove(&task->queue);
+        nlist_dll_init(&task->queue);
+    } else if (*level == &task->queue) {
+        *level = NULL;
+        NBITARRAY_CLEAR(&ready->bitarray, task->prio);
+    }
 }
 
-/*
- * 1. If no ready task is set then set the default idle task.
- */
-NPLATFORM_NORETURN(void nscheduler_start(
+void nscheduler_start(
         struct nscheduler * scheduler, 
-        const struct nepa * const * epa_registry))
+        struct nepa * const * epa_registry)
 {
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+    g_local_scheduler = scheduler;
+    schedule_initialize_epas(scheduler, epa_registry);
+#else
     schedule_initialize_epas(scheduler, epa_registry);
+    schedule_initialize_idle(scheduler);
+#endif
+
+    while (schedule_should_run(scheduler)) {
+        struct nos_critical local;
+        struct nscheduler_task * task;
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+        schedule_drain_inbound(scheduler);
+
+        if (NBITARRAY_IS_EMPTY(&scheduler->ready.bitarray)) {
+            nos_wakeup_wait(&scheduler->wakeup);
+            continue;
+        }
+#endif
+#if (SYS_USE_TICKLESS_IDLE == 1)
+        idle_update_timer();
+#endif
+        schedule_lock(&local);
+        task = schedule_next(&scheduler->ready);
+        scheduler->current = task;
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+        scheduler->ceiling = task->prio;
+#endif
+        schedule_unlock(&local);
+        task->fn(task, task->arg);
+    }
+    scheduler->current = NULL;
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+    g_local_scheduler = NULL;
+#endif
+}
+
+#if (NCONFIG_SYS_EXITABLE_SCHEDULER == 1)
+void nscheduler_stop(struct nscheduler * scheduler)
+{
+    narch_atomic_store_u32(&scheduler->should_exit, 1u);
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+    nos_wakeup_signal(&scheduler->wakeup);
+#endif
+#if (SYS_USE_TICKLESS_IDLE == 1)
+    nos_idle_wakeup();
+#endif
+}
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+/* Run ready tasks above the ceiling on the current stack. Each preempting
+ * task raises the ceiling to its own priority, so it can be preempted only by
+ * a task of even higher priority. With multi-producer queues a preempted
+ * sender may hold a half put event, then the loop returns to it and the
+ * ready task runs later.
+ */
+void nscheduler_preempt(struct nscheduler * scheduler)
+{
+    struct nos_critical local;
+
+    schedule_lock(&local);
+
+    if (scheduler->isr_nesting == 0u) {
+        uint_fast8_t ceiling = scheduler->ceiling;
+        struct nscheduler_task * current = scheduler->current;
+
+        while (!NBITARRAY_IS_EMPTY(&scheduler->ready.bitarray) &&
+                (NBITARRAY_MSBS(&scheduler->ready.bitarray) > ceiling)) {
+            struct nscheduler_task * task;
+
+            task = schedule_next(&scheduler->ready);
+            scheduler->current = task;
+            scheduler->ceiling = task->prio;
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+            scheduler->is_stalled = false;
+#endif
+            schedule_unlock(&local);
+            task->fn(task, task->arg);
+            schedule_lock(&local);
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+            if (scheduler->is_stalled) {
+                scheduler->is_stalled = false;
+                break;
+            }
+#endif
+        }
+        scheduler->ceiling = ceiling;
+        scheduler->current = current;
+    }
+    schedule_unlock(&local);
+}
+
+uint_fast8_t nscheduler_ceiling_raise(
+        struct nscheduler * scheduler,
+        uint_fast8_t ceiling)
+{
+    struct nos_critical local;
+    uint_fast8_t previous;
+
+    schedule_lock(&local);
+    previous = scheduler->ceiling;
+
+    if (ceiling > previous) {
+        scheduler->ceiling = ceiling;
+    }
+    schedule_unlock(&local);
+
+    return previous;
+}
+
+void nscheduler_ceiling_restore(
+        struct nscheduler * scheduler,
+        uint_fast8_t ceiling)
+{
+    struct nos_critical local;
+
+    schedule_lock(&local);
+    scheduler->ceiling = ceiling;
+    schedule_unlock(&local);
+    nscheduler_preempt(scheduler);
+}
+
+void nscheduler_isr_enter(struct nscheduler * scheduler)
+{
+    struct nos_critical local;
+
+    schedule_lock(&local);
+    scheduler->isr_nesting++;
+    schedule_unlock(&local);
+}
+
+void nscheduler_isr_exit(struct nscheduler * scheduler)
+{
+    struct nos_critical local;
+
+    schedule_lock(&local);
+    scheduler->isr_nesting--;
+    schedule_unlock(&local);
+    nscheduler_preempt(scheduler);
+}
+#endif
+
+/** @} *//*==================================================================*/
+/** @defgroup   nscheduler_pool_impl Work-stealing pool implementation
+ *  @brief      Work-stealing pool implementation
+ *  @{ *//*==================================================================*/
+
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+
+/** @brief      Pool worker executed by the current thread.
+ */
+static NPLATFORM_THREAD_LOCAL struct nscheduler_worker * g_local_worker;
+
+/* Each registered EPA is queued at most once, so the queue can not be full
+ * while the pool holds no more EPAs than the queue size.
+ */
+static void worker_push(struct nscheduler_worker * worker, struct nepa * epa)
+{
+    bool is_full;
+
+    nos_lock_acquire(&worker->lock);
+    is_full = NLQUEUE_IS_FULL(&worker->ready);
+
+    if (!is_full) {
+        NLQUEUE_PUT_FIFO(&worker->ready, epa);
+    }
+    nos_lock_release(&worker->lock);
+
+    if (is_full) {
+        nexception_raise(NEXCEPTION_RUNTIME);
+    }
+}
+
+static struct nepa * worker_pop(struct nscheduler_worker * worker)
+{
+    struct nepa * epa = NULL;
 
-    while (true) {
-     
+    nos_lock_acquire(&worker->lock);
+
+    if (!NLQUEUE_IS_EMPTY(&worker->ready)) {
+        epa = NLQUEUE_GET(&worker->ready);
+    }
+    nos_lock_release(&worker->lock);
+
+    return epa;
+}
+
+static struct nscheduler_worker * worker_next(
+        struct nscheduler_pool * pool,
+        const struct nscheduler_worker * worker)
+{
+    uint_fast8_t idx = (uint_fast8_t)(worker - &pool->workers[0]) + 1u;
+
+    if (idx == NCONFIG_SCHEDULER_POOL_WORKERS) {
+        idx = 0u;
+    }
+    return &pool->workers[idx];
+}
+
+/* Put a ready EPA into a worker queue. A worker thread keeps the EPA for
+ * itself and wakes up the next worker which may steal it. Other threads
+ * distribute the EPAs between workers in round-robin fashion.
+ */
+static void pool_schedule(struct nscheduler_pool * pool, struct nepa * epa)
+{
+    struct nscheduler_worker * worker = g_local_worker;
+
+    if ((worker != NULL) && (worker->pool == pool)) {
+        worker_push(worker, epa);
+        worker = worker_next(pool, worker);
+    } else {
+        uint32_t idx;
+
+        do {
+            idx = narch_atomic_load_u32(&pool->next_worker);
+            worker = &pool->workers[idx];
+        } while (!narch_atomic_cas_u32(&pool->next_worker, idx,
+                (uint32_t)(worker_next(pool, worker) - &pool->workers[0])));
+        worker_push(worker, epa);
+    }
+    nos_wakeup_signal(&worker->wakeup);
+}
+
+static nerror pool_post(
+        struct nscheduler_pool * pool,
+        struct nepa * epa,
+        struct nequeue * lane,
+        const struct nevent * event)
+{
+    nerror error;
+    bool should_schedule = false;
+
+    nevent_ref_up(event);
+    nos_lock_acquire(&epa->pool.lock);
+
+    if (!NLQUEUE_IS_FULL(lane)) {
+        NLQUEUE_PUT_FIFO(lane, event);
+
+        if (!epa->pool.is_queued) {
+            epa->pool.is_queued = true;
+            should_schedule = true;
+        }
+        error = EOK;
+    } else {
+        error = -EOBJ_INVALID;
+    }
+    nos_lock_release(&epa->pool.lock);
+
+    if (should_schedule) {
+        pool_schedule(pool, epa);
+    } else if (error != EOK) {
+        /* Undo the nevent_ref_up step from above.
+         */
+        nevent_ref_down(event);
+    }
+    return error;
+}
+
+/* Get a ready EPA from own queue, or steal one from other workers.
+ */
+static struct nepa * pool_find_work(struct nscheduler_worker * worker)
+{
+    struct nscheduler_worker * victim;
+    struct nepa * epa;
+
+    epa = worker_pop(worker);
+
+    for (victim = worker_next(worker->pool, worker);
+         (epa == NULL) && (victim != worker);
+         victim = worker_next(worker->pool, victim)) {
+        epa = worker_pop(victim);
+    }
+    return epa;
+}
+
+static void pool_dispatch(struct nepa * epa)
+{
+    const struct nevent * batch[NCONFIG_EPA_EVENT_BUDGET];
+    uint_fast8_t count;
+    bool should_schedule;
+
+    nos_lock_acquire(&epa->pool.lock);
+    count = epa_claim(epa, batch);
+    nos_lock_release(&epa->pool.lock);
+    epa_dispatch_batch(epa, batch, count);
+    nos_lock_acquire(&epa->pool.lock);
+    should_schedule = !epa_is_idle(epa);
+    epa->pool.is_queued = should_schedule;
+    nos_lock_release(&epa->pool.lock);
+
+    if (should_schedule) {
+        pool_schedule(epa->pool.pool, epa);
+    }
+}
+
+void nscheduler_pool_init(struct nscheduler_pool * pool)
+{
+    for (uint_fast8_t i = 0u; i < NCONFIG_SCHEDULER_POOL_WORKERS; i++) {
+        struct nscheduler_worker * worker = &pool->workers[i];
+
+        worker->pool = pool;
+        worker->wakeup.state = 0u;
+        worker->lock.state = 0u;
+        NLQUEUE_INIT(&worker->ready);
+    }
+    pool->next_worker = 0u;
+    pool->should_exit = 0u;
+    pool->epas = 0u;
+}
+
+nerror nscheduler_pool_register(
+        struct nscheduler_pool * pool,
+        struct nepa * const * epa_registry)
+{
+    uint32_t epas = pool->epas;
+
+    /* Check the whole registry first, so a rejected registry leaves no EPA
+     * bound to the pool. EPAs registered by earlier calls are counted too,
+     * since any of them may end up in the same worker queue.
+     */
+    for (uint32_t i = 0u; epa_registry[i] != NULL; i++) {
+        if (++epas > NCONFIG_SCHEDULER_POOL_QUEUE_SIZE) {
+            return -EARG_OUTOFRANGE;
+        }
     }
+    pool->epas = epas;
+
+    while (*epa_registry != NULL) {
+        struct nepa * epa = *epa_registry;
+
+        epa->pool.pool = pool;
+        epa->pool.lock.state = 0u;
+        epa->pool.is_queued = false;
+        epa_budget_init(epa);
+        epa_urgent_init(epa);
+        nepa_send_signal(epa, NSM_INIT);
+        epa_registry++;
+    }
+    return EOK;
+}
+
+void nscheduler_pool_worker(
+        struct nscheduler_pool * pool,
+        uint_fast8_t worker_id)
+{
+    struct nscheduler_worker * worker = &pool->workers[worker_id];
+
+    g_local_worker = worker;
+
+    while (narch_atomic_load_u32(&pool->should_exit) == 0u) {
+        struct nepa * epa;
+
+        epa = pool_find_work(worker);
+
+        if (epa != NULL) {
+            pool_dispatch(epa);
+        } else {
+            nos_wakeup_wait(&worker->wakeup);
+        }
+    }
+    g_local_worker = NULL;
 }
 
+void nscheduler_pool_stop(struct nscheduler_pool * pool)
+{
+    narch_atomic_store_u32(&pool->should_exit, 1u);
+
+    for (uint_fast8_t i = 0u; i < NCONFIG_SCHEDULER_POOL_WORKERS; i++) {
+        nos_wakeup_signal(&pool->workers[i].wakeup);
+    }
+}
+#endif
+
 /** @} *//*==================================================================*/
 /** @defgroup   nsys System module
  *  @brief      System module
@@ -164,11 +1337,122 @@ static nsm_action idle_state_init(struct nsm * sm, const struct nevent * event)
     return nsm_event_ignored();
 }
 
-const struct nepa nsys_epa_idle = NEPA_INITIALIZER(
+#if (SYS_USE_TICKLESS_IDLE == 1)
+/** @brief      System tick count at the last timing wheel update.
+ */
+static uint32_t g_idle_ticks;
+
+struct ntimer_wheel nsys_timer_wheel;
+
+static void idle_initialize_timer(void)
+{
+    ntimer_wheel_init(&nsys_timer_wheel);
+    g_idle_ticks = nos_tick_count();
+}
+
+/* Catch up the timing wheel with elapsed time. Called by the scheduler before
+ * each task is selected, so the timers expire also when the scheduler is
+ * never idle.
+ */
+static void idle_update_timer(void)
+{
+    uint32_t ticks = nos_tick_count();
+
+    if (ticks != g_idle_ticks) {
+        ntimer_wheel_advance(&nsys_timer_wheel, ticks - g_idle_ticks);
+        g_idle_ticks = ticks;
+    }
+}
+
+void np_sys_timer_armed(struct ntimer_wheel * wheel)
+{
+    struct nos_critical local;
+    bool should_wakeup;
+
+    if (wheel != &nsys_timer_wheel) {
+        return;
+    }
+    schedule_lock(&local);
+    should_wakeup = idle_claim_wakeup();
+    schedule_unlock(&local);
+
+    if (should_wakeup) {
+        nos_idle_wakeup();
+    }
+}
+
+/* Sleep until the next timing wheel work. The sleeping flag is set in the
+ * same critical section in which the ready queue is checked, so an event sent
+ * after the check always wakes up the sleep. The next timer is fetched after
+ * the flag is set, so a timer armed before that is seen here and a timer
+ * armed later wakes up the sleep.
+ */
+static void idle_sleep(struct nscheduler * scheduler)
+{
+    struct nos_critical local;
+    uint32_t next;
+    bool should_sleep;
+
+    idle_update_timer();
+    schedule_lock(&local);
+    should_sleep = schedule_should_run(scheduler) &&
+            (NBITARRAY_MSBS(&scheduler->ready.bitarray) == NEPA_PRIO_MIN) &&
+            epa_is_idle(&nsys_epa_idle);
+    g_idle_is_sleeping = should_sleep;
+    schedule_unlock(&local);
+
+    if (should_sleep) {
+        next = ntimer_wheel_next(&nsys_timer_wheel);
+        nos_idle_sleep(next == NTIMER_INFINITE ? NOS_IDLE_FOREVER : next);
+        schedule_lock(&local);
+        g_idle_is_sleeping = false;
+        schedule_unlock(&local);
+    }
+}
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 0)
+/* When the idle EPA has no events in its queue it receives NEVENT_NULL
+ * signal on each activation.
+ */
+static void idle_dispatch(struct nscheduler_task * task, void * arg)
+{
+    struct nepa * epa = arg;
+    const struct nevent * event;
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 0)
+    struct nos_critical local;
+#endif
+
+    NPLATFORM_UNUSED_ARG(task);
+    event = nsm_signal(NEVENT_NULL);
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+    if (!NLQUEUE_MPSC_IS_EMPTY(&epa->equeue)) {
+        NLQUEUE_MPSC_GET(&epa->equeue, event);
+        (void)narch_atomic_sub_u32(&epa->pending, 1u);
+    }
+#else
+    schedule_lock(&local);
+
+    if (!NLQUEUE_IS_EMPTY(&epa->equeue)) {
+        event = NLQUEUE_GET(&epa->equeue);
+    }
+    schedule_unlock(&local);
+#endif
+    nsm_dispatch(&epa->sm, event);
+    epa_arena_reset(epa);
+    nevent_delete(event);
+#if (SYS_USE_TICKLESS_IDLE == 1)
+    idle_sleep(epa->scheduler);
+#endif
+}
+#endif
+
+struct nepa nsys_epa_idle = NEPA_INITIALIZER(
             &g_epa_queue_idle, 
             NEPA_FSM_TYPE, 
             idle_state_init, 
-            NULL);
+            NULL,
+            NEPA_PRIO_MIN);
 
 void nsys_init(void)
 {
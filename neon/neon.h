@@ -21,12 +21,15 @@
 #include "core/nlist_dll.h"
 #include "core/nlqueue.h"
 #include "core/npqueue.h"
+#include "core/nheap.h"
 #include "core/nbitarray.h"
 #include "core/nmempool.h"
+#include "core/narena.h"
 #include "core/nevent.h"
 #include "core/nsm.h"
 #include "core/nepa.h"
 #include "core/nscheduler.h"
+#include "core/ntimer.h"
 
 #include "lib/nstdio.h"
 #include "lib/nlogger.h"
@@ -37,7 +40,16 @@ extern "C" {
 
 /** @brief      Defines system Idle EPA description
  */
-extern const struct nepa nsys_epa_idle;
+extern struct nepa nsys_epa_idle;
+
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1) || defined(__DOXYGEN__)
+/** @brief      System timing wheel serviced by the idle EPA
+ *
+ *  The timing wheel is driven by @ref nos_tick_count and it is initialized
+ *  when the scheduler is started. See @ref NCONFIG_SYS_USE_TICKLESS_IDLE.
+ */
+extern struct ntimer_wheel nsys_timer_wheel;
+#endif
 
 /** @brief      System initialization function
  * 
@@ -48,6 +48,7 @@ extern "C" {
 #define NARCH_ID "armv7_m"
 #define NARCH_DATA_WIDTH 32 /* sizeof(uint32_t) * 8 */
 #define NARCH_ARMV7_M 1
+#define NARCH_HAS_ATOMICS 1
 
 typedef uint32_t uint32_t;
 
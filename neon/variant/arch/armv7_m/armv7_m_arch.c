@@ -0,0 +1,163 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#include "core/nport.h"
+
+/* Exclusive load/store loops. STREXH returns 0 when the store succeeded, or
+ * 1 when the exclusive monitor was lost (an interrupt or other bus master
+ * accessed the location) and the loop must be retried.
+ */
+uint_fast16_t narch_atomic_inc_u16(uint16_t * u16)
+{
+    uint32_t value;
+    uint32_t failed;
+
+    do {
+        __asm__ __volatile__ (
+            "   ldrexh  %0, [%1]                                \n"
+            : "=r"(value)
+            : "r"(u16)
+            : "memory");
+        value++;
+        __asm__ __volatile__ (
+            "   strexh  %0, %2, [%1]                            \n"
+            : "=&r"(failed)
+            : "r"(u16), "r"(value)
+            : "memory");
+    } while (failed);
+
+    return (uint16_t)value;
+}
+
+uint_fast16_t narch_atomic_dec_u16(uint16_t * u16)
+{
+    uint32_t value;
+    uint32_t failed;
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    do {
+        __asm__ __volatile__ (
+            "   ldrexh  %0, [%1]                                \n"
+            : "=r"(value)
+            : "r"(u16)
+            : "memory");
+        value--;
+        __asm__ __volatile__ (
+            "   strexh  %0, %2, [%1]                            \n"
+            : "=&r"(failed)
+            : "r"(u16), "r"(value)
+            : "memory");
+    } while (failed);
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    return (uint16_t)value;
+}
+
+/* Aligned word accesses are single-copy atomic, the barriers only order them
+ * with respect to other memory accesses.
+ */
+uint32_t narch_atomic_load_u32(const uint32_t * u32)
+{
+    uint32_t value = *(const volatile uint32_t *)u32;
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    return value;
+}
+
+void narch_atomic_store_u32(uint32_t * u32, uint32_t value)
+{
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+    *(volatile uint32_t *)u32 = value;
+}
+
+static uint32_t atomic_add_u32(uint32_t * u32, uint32_t value)
+{
+    uint32_t result;
+    uint32_t failed;
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    do {
+        __asm__ __volatile__ (
+            "   ldrex   %0, [%1]                                \n"
+            : "=r"(result)
+            : "r"(u32)
+            : "memory");
+        result += value;
+        __asm__ __volatile__ (
+            "   strex   %0, %2, [%1]                            \n"
+            : "=&r"(failed)
+            : "r"(u32), "r"(result)
+            : "memory");
+    } while (failed);
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    return result;
+}
+
+uint32_t narch_atomic_add_u32(uint32_t * u32, uint32_t value)
+{
+    return atomic_add_u32(u32, value);
+}
+
+uint32_t narch_atomic_sub_u32(uint32_t * u32, uint32_t value)
+{
+    return atomic_add_u32(u32, 0u - value);
+}
+
+void narch_atomic_fence_acquire(void)
+{
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+}
+
+/* CLREX releases the exclusive monitor when the compare fails, so a later
+ * STREX in an interrupt handler is not affected.
+ */
+bool narch_atomic_cas_u32(uint32_t * u32, uint32_t expected,
+        uint32_t desired)
+{
+    uint32_t current;
+    uint32_t failed;
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    do {
+        __asm__ __volatile__ (
+            "   ldrex   %0, [%1]                                \n"
+            : "=r"(current)
+            : "r"(u32)
+            : "memory");
+
+        if (current != expected) {
+            __asm__ __volatile__ ("   clrex                                   \n"
+                    ::: "memory");
+            return false;
+        }
+        __asm__ __volatile__ (
+            "   strex   %0, %2, [%1]                            \n"
+            : "=&r"(failed)
+            : "r"(u32), "r"(desired)
+            : "memory");
+    } while (failed);
+
+    __asm__ __volatile__ ("   dmb                                     \n"
+            ::: "memory");
+
+    return true;
+}
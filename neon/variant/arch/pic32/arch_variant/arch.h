@@ -143,6 +143,18 @@ void narch_atomic_clear_bit(uint32_t * u32, uint_fast8_t bit)
     __sync_fetch_and_and(u32, ~narch_exp2(bit));
 }
 
+NPLATFORM_INLINE
+uint_fast16_t narch_atomic_inc_u16(uint16_t * u16)
+{
+    return __sync_add_and_fetch(u16, 1u);
+}
+
+NPLATFORM_INLINE
+uint_fast16_t narch_atomic_dec_u16(uint16_t * u16)
+{
+    return __sync_sub_and_fetch(u16, 1u);
+}
+
 #endif /* (NARCH_HAS_CAS == 1) */
 
 
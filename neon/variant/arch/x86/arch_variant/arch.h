@@ -50,7 +50,8 @@ extern "C" {
 #define NARCH_DATA_WIDTH 				32 /* sizeof(uint32_t) * 8 */
 
 #define NARCH_ALIGN						4
-#define NARCH_HAS_ATOMICS				0
+#define NARCH_CACHE_LINE				64
+#define NARCH_HAS_ATOMICS				1
 #define NARCH_HAS_EXCLUSIVE_LS			0
 
 typedef uint32_t uint32_t;
@@ -21,7 +21,7 @@
 #include "core/nport.h"
 
 const char * const narch_id = "x86";
-const bool narch_has_atomics = false;
+const bool narch_has_atomics = true;
 
 void narch_cpu_stop(void)
 {
@@ -37,3 +37,45 @@ uint_fast8_t narch_log2(uint32_t x)
 {
 	return (31 - __builtin_clz(x));
 }
+
+uint_fast16_t narch_atomic_inc_u16(uint16_t * u16)
+{
+    return __atomic_add_fetch(u16, 1u, __ATOMIC_RELAXED);
+}
+
+uint_fast16_t narch_atomic_dec_u16(uint16_t * u16)
+{
+    return __atomic_sub_fetch(u16, 1u, __ATOMIC_ACQ_REL);
+}
+
+uint32_t narch_atomic_load_u32(const uint32_t * u32)
+{
+    return __atomic_load_n(u32, __ATOMIC_ACQUIRE);
+}
+
+void narch_atomic_store_u32(uint32_t * u32, uint32_t value)
+{
+    __atomic_store_n(u32, value, __ATOMIC_RELEASE);
+}
+
+uint32_t narch_atomic_add_u32(uint32_t * u32, uint32_t value)
+{
+    return __atomic_add_fetch(u32, value, __ATOMIC_SEQ_CST);
+}
+
+uint32_t narch_atomic_sub_u32(uint32_t * u32, uint32_t value)
+{
+    return __atomic_sub_fetch(u32, value, __ATOMIC_SEQ_CST);
+}
+
+void narch_atomic_fence_acquire(void)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+bool narch_atomic_cas_u32(uint32_t * u32, uint32_t expected,
+        uint32_t desired)
+{
+    return __atomic_compare_exchange_n(u32, &expected, desired, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
@@ -5,11 +5,38 @@
  *      Author: nenad
  */
 
+#define _GNU_SOURCE
+
 #include "core/nport.h"
 
 #include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <linux/futex.h>
+
+#define HUGE_PAGE_SIZE                  ((size_t)2u * 1024u * 1024u)
 
 static pthread_mutex_t g_nglobal_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_idle_once = PTHREAD_ONCE_INIT;
+static int g_idle_epoll = -1;
+static int g_idle_timer = -1;
+static int g_idle_event = -1;
+
+void nos_word_wait(uint32_t * word, uint32_t expected)
+{
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+void nos_word_wake(uint32_t * word, uint32_t count)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, (int)count, NULL, NULL, 0);
+}
 
 void nos_critical_lock(struct nos_critical * lock)
 {
@@ -22,3 +49,233 @@ void nos_critical_unlock(struct nos_critical * lock)
     NPLATFORM_UNUSED_ARG(lock);
 	pthread_mutex_unlock(&g_nglobal_mutex);
 }
+
+/* Lock states:
+ * 0 - unlocked
+ * 1 - locked, no waiters
+ * 2 - locked, there may be waiters
+ */
+void nos_lock_acquire(struct nos_lock * lock)
+{
+    uint32_t state = 0u;
+
+    if (__atomic_compare_exchange_n(&lock->state, &state, 1u, false,
+            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    if (state != 2u) {
+        state = __atomic_exchange_n(&lock->state, 2u, __ATOMIC_ACQUIRE);
+    }
+
+    while (state != 0u) {
+        nos_word_wait(&lock->state, 2u);
+        state = __atomic_exchange_n(&lock->state, 2u, __ATOMIC_ACQUIRE);
+    }
+}
+
+void nos_lock_release(struct nos_lock * lock)
+{
+    if (__atomic_fetch_sub(&lock->state, 1u, __ATOMIC_RELEASE) != 1u) {
+        __atomic_store_n(&lock->state, 0u, __ATOMIC_RELEASE);
+        nos_word_wake(&lock->state, 1u);
+    }
+}
+
+/* Wake-up states:
+ * 0 - no pending signal, the owner is running
+ * 1 - signal is pending
+ * 2 - no pending signal, the owner is sleeping
+ */
+void nos_wakeup_wait(struct nos_wakeup * wakeup)
+{
+    uint32_t state = 0u;
+
+    if (__atomic_compare_exchange_n(&wakeup->state, &state, 2u, false,
+            __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        state = 2u;
+    }
+
+    while (state == 2u) {
+        nos_word_wait(&wakeup->state, 2u);
+        state = __atomic_load_n(&wakeup->state, __ATOMIC_ACQUIRE);
+    }
+    __atomic_store_n(&wakeup->state, 0u, __ATOMIC_RELEASE);
+}
+
+void nos_wakeup_signal(struct nos_wakeup * wakeup)
+{
+    if (__atomic_exchange_n(&wakeup->state, 1u, __ATOMIC_RELEASE) == 2u) {
+        nos_word_wake(&wakeup->state, 1u);
+    }
+}
+
+nerror nos_thread_pin(uint_fast16_t cpu)
+{
+    cpu_set_t cpu_set;
+
+    if (cpu >= CPU_SETSIZE) {
+        return -EARG_OUTOFRANGE;
+    }
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)) {
+        return -EARG_OUTOFRANGE;
+    }
+    return EOK;
+}
+
+static size_t mem_map_size(size_t size, uint32_t flags)
+{
+    if (flags & NOS_MEM_HUGE_PAGES) {
+        return (size + HUGE_PAGE_SIZE - 1u) & ~(HUGE_PAGE_SIZE - 1u);
+    }
+    return size;
+}
+
+/* The fallback mapping is one huge page larger than needed and the unused
+ * ends are unmapped, so the mapping starts on a huge page boundary and the
+ * transparent huge pages can back the whole of it.
+ */
+static void * mem_map_huge_aligned(size_t size)
+{
+    char * mem;
+    char * aligned;
+    size_t head;
+
+    mem = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (mem == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    aligned = (char *)(((uintptr_t)mem + HUGE_PAGE_SIZE - 1u) &
+            ~((uintptr_t)HUGE_PAGE_SIZE - 1u));
+    head = (size_t)(aligned - mem);
+
+    if (head != 0u) {
+        munmap(mem, head);
+    }
+    munmap(aligned + size, HUGE_PAGE_SIZE - head);
+    (void)madvise(aligned, size, MADV_HUGEPAGE);
+
+    return aligned;
+}
+
+/* Huge page sized mappings are used also for the fallback mapping, so the
+ * size given to munmap does not depend on which mapping succeeded.
+ */
+void * nos_mem_map(size_t size, uint32_t flags)
+{
+    void * mem = MAP_FAILED;
+
+    if (size > (SIZE_MAX - 2u * HUGE_PAGE_SIZE)) {
+        return NULL;
+    }
+    size = mem_map_size(size, flags);
+
+    if (flags & NOS_MEM_HUGE_PAGES) {
+        mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (mem == MAP_FAILED) {
+            mem = mem_map_huge_aligned(size);
+        }
+    } else {
+        mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+
+    if ((flags & NOS_MEM_LOCKED) && mlock(mem, size)) {
+        munmap(mem, size);
+
+        return NULL;
+    }
+    return mem;
+}
+
+void nos_mem_unmap(void * mem, size_t size, uint32_t flags)
+{
+    munmap(mem, mem_map_size(size, flags));
+}
+
+uint32_t nos_tick_count(void)
+{
+    struct timespec now;
+    uint64_t us;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    us = (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+
+    return (uint32_t)(us / NCONFIG_SYS_TICK_US);
+}
+
+static void idle_init(void)
+{
+    struct epoll_event event = {
+        .events = EPOLLIN
+    };
+
+    g_idle_epoll = epoll_create1(EPOLL_CLOEXEC);
+    g_idle_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    g_idle_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    event.data.fd = g_idle_timer;
+    epoll_ctl(g_idle_epoll, EPOLL_CTL_ADD, g_idle_timer, &event);
+    event.data.fd = g_idle_event;
+    epoll_ctl(g_idle_epoll, EPOLL_CTL_ADD, g_idle_event, &event);
+}
+
+/* The timer file descriptor is armed only when a timeout is requested, so a
+ * sleeping process is woken up only by the next deadline or by an event.
+ */
+void nos_idle_sleep(uint32_t ticks)
+{
+    struct epoll_event events[2];
+    int count;
+
+    if (ticks == 0u) {
+        return;
+    }
+    pthread_once(&g_idle_once, idle_init);
+
+    if (ticks != NOS_IDLE_FOREVER) {
+        uint64_t us = (uint64_t)ticks * NCONFIG_SYS_TICK_US;
+        struct itimerspec timeout = {
+            .it_value = {
+                .tv_sec = (time_t)(us / 1000000u),
+                .tv_nsec = (long)(us % 1000000u) * 1000
+            }
+        };
+        timerfd_settime(g_idle_timer, 0, &timeout, NULL);
+    }
+
+    do {
+        count = epoll_wait(g_idle_epoll, events, 2, -1);
+    } while (count < 0);
+
+    for (int i = 0; i < count; i++) {
+        uint64_t value;
+
+        /* Clear the pending timer expiration and wake-up counter.
+         */
+        (void)read(events[i].data.fd, &value, sizeof(value));
+    }
+
+    if (ticks != NOS_IDLE_FOREVER) {
+        struct itimerspec disarm = { 0 };
+        timerfd_settime(g_idle_timer, 0, &disarm, NULL);
+    }
+}
+
+void nos_idle_wakeup(void)
+{
+    uint64_t value = 1u;
+
+    pthread_once(&g_idle_once, idle_init);
+    (void)write(g_idle_event, &value, sizeof(value));
+}
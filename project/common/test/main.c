@@ -32,6 +32,30 @@
 #include "test_nlqueue.h"
 #endif
 
+#if defined(NEON_TEST_NPQUEUE)
+#include "test_npqueue.h"
+#endif
+
+#if defined(NEON_TEST_NHEAP)
+#include "test_nheap.h"
+#endif
+
+#if defined(NEON_TEST_NARENA)
+#include "test_narena.h"
+#endif
+
+#if defined(NEON_TEST_NSCHEDULER)
+#include "test_nscheduler.h"
+#endif
+
+#if defined(NEON_TEST_NTIMER)
+#include "test_ntimer.h"
+#endif
+
+#if defined(NEON_TEST_NEVENT)
+#include "test_nevent.h"
+#endif
+
 int main(void)
 {
 	static ntestsuite_fn * const tests[] =
@@ -53,6 +77,24 @@ int main(void)
 #endif
 #if defined(NEON_TEST_NLQUEUE)
 		test_exec_nlqueue,
+#endif
+#if defined(NEON_TEST_NPQUEUE)
+		test_exec_npqueue,
+#endif
+#if defined(NEON_TEST_NHEAP)
+		test_exec_nheap,
+#endif
+#if defined(NEON_TEST_NARENA)
+		test_exec_narena,
+#endif
+#if defined(NEON_TEST_NSCHEDULER)
+		test_exec_nscheduler,
+#endif
+#if defined(NEON_TEST_NTIMER)
+		test_exec_ntimer,
+#endif
+#if defined(NEON_TEST_NEVENT)
+		test_exec_nevent,
 #endif
 		NULL
 	};
@@ -0,0 +1,120 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../testsuite/ntestsuite.h"
+#include "core/narena.h"
+#include "test_narena.h"
+
+#define ARENA_SIZE                      (8u * NARENA_ALIGN)
+
+static struct test_arena narena(ARENA_SIZE) g_arena;
+
+static bool is_aligned(const void * mem)
+{
+    return ((uintptr_t)mem & (NARENA_ALIGN - 1u)) == 0u;
+}
+
+NTESTSUITE_TEST(test_empty_alloc)
+{
+    void * mem = narena_alloc(NARENA(&g_arena), 1u);
+
+    ntestsuite_not_expect_ptr(NULL);
+    ntestsuite_actual_ptr(mem);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(is_aligned(mem));
+}
+
+NTESTSUITE_TEST(test_empty_alloc_aligned)
+{
+    uint32_t errors = 0u;
+
+    for (uint32_t i = 0u; i < 4u; i++) {
+        void * mem = narena_alloc(NARENA(&g_arena), 1u + i);
+
+        if ((mem == NULL) || !is_aligned(mem)) {
+            errors++;
+        }
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(errors);
+}
+
+NTESTSUITE_TEST(test_empty_alloc_exhausted)
+{
+    void * mem;
+
+    mem = narena_alloc(NARENA(&g_arena), ARENA_SIZE + 1u);
+    ntestsuite_expect_ptr(NULL);
+    ntestsuite_actual_ptr(mem);
+
+    mem = narena_alloc(NARENA(&g_arena), ARENA_SIZE);
+    ntestsuite_not_expect_ptr(NULL);
+    ntestsuite_actual_ptr(mem);
+
+    mem = narena_alloc(NARENA(&g_arena), 1u);
+    ntestsuite_expect_ptr(NULL);
+    ntestsuite_actual_ptr(mem);
+}
+
+NTESTSUITE_TEST(test_empty_alloc_size_max)
+{
+    void * mem;
+
+    /* The first allocation leaves padding for the next one.
+     */
+    narena_alloc(NARENA(&g_arena), 1u);
+    mem = narena_alloc(NARENA(&g_arena), SIZE_MAX);
+    ntestsuite_expect_ptr(NULL);
+    ntestsuite_actual_ptr(mem);
+}
+
+NTESTSUITE_TEST(test_empty_reset_mark)
+{
+    void * first;
+    void * second;
+    size_t mark;
+
+    (void)narena_alloc(NARENA(&g_arena), 3u);
+    mark = narena_mark(NARENA(&g_arena));
+    first = narena_alloc(NARENA(&g_arena), 5u);
+    (void)narena_alloc(NARENA(&g_arena), 7u);
+    narena_reset(NARENA(&g_arena), mark);
+    second = narena_alloc(NARENA(&g_arena), 5u);
+
+    ntestsuite_expect_ptr(first);
+    ntestsuite_actual_ptr(second);
+}
+
+NTESTSUITE_TEST(test_empty_reset_all)
+{
+    (void)narena_alloc(NARENA(&g_arena), ARENA_SIZE);
+    narena_reset(NARENA(&g_arena), 0u);
+
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(NARENA_USED(&g_arena));
+    ntestsuite_not_expect_ptr(NULL);
+    ntestsuite_actual_ptr(narena_alloc(NARENA(&g_arena), ARENA_SIZE));
+}
+
+static void setup_empty(void)
+{
+    NARENA_INIT(&g_arena);
+}
+
+void test_exec_narena(void)
+{
+    ntestsuite_set_fixture(empty, setup_empty, NULL);
+    ntestsuite_run(test_empty_alloc);
+    ntestsuite_run(test_empty_alloc_aligned);
+    ntestsuite_run(test_empty_alloc_exhausted);
+    ntestsuite_run(test_empty_alloc_size_max);
+    ntestsuite_run(test_empty_reset_mark);
+    ntestsuite_run(test_empty_reset_all);
+}
@@ -72,6 +72,24 @@ NTESTSUITE_TEST(test_none_set_1_and_clear_2)
     ntestsuite_actual_bool(NBITARRAY_IS_EMPTY(&my_array));
 }
 
+NTESTSUITE_TEST(test_none_lsbs_above)
+{
+    struct nbitarray(64) my_array;
+
+    NBITARRAY_INIT(&my_array);
+    NBITARRAY_SET(&my_array, 3);
+    NBITARRAY_SET(&my_array, 33);
+
+    ntestsuite_expect_uint(3u);
+    ntestsuite_actual_uint(NBITARRAY_LSBS_ABOVE(&my_array, 1));
+    ntestsuite_expect_uint(33u);
+    ntestsuite_actual_uint(NBITARRAY_LSBS_ABOVE(&my_array, 3));
+    ntestsuite_expect_uint(33u);
+    ntestsuite_actual_uint(NBITARRAY_LSBS_ABOVE(&my_array, 31));
+    ntestsuite_expect_uint(40u);
+    ntestsuite_actual_uint(NBITARRAY_LSBS_ABOVE(&my_array, 40));
+}
+
 void test_exec_nbitarray(void)
 {
     ntestsuite_set_fixture(none, NULL, NULL);
@@ -81,4 +99,5 @@ void test_exec_nbitarray(void)
     ntestsuite_run(test_none_is_not_empty);
     ntestsuite_run(test_none_set_1_and_clear_1);
     ntestsuite_run(test_none_set_1_and_clear_2);
+    ntestsuite_run(test_none_lsbs_above);
 }
@@ -0,0 +1,522 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../testsuite/ntestsuite.h"
+#include "neon.h"
+#include "test_nevent.h"
+
+#define REF_THREADS                     4u
+#define REF_ROUNDS                      100000u
+#define POOL_ROUNDS                     100000u
+#define MAPPED_POOL_SIZE                1000u
+
+static struct test_pool npool(struct nevent, 2) g_pool;
+static struct test_aligned_pool npool_aligned(uint8_t, 4) g_aligned_pool;
+
+#if (NCONFIG_MEMPOOL_USE_LOCK_FREE == 1)
+#define LARGE_POOL_SIZE                 70000u
+#define LARGE_POOL_LIMIT                65535u
+
+static struct test_large_pool npool(uint32_t, LARGE_POOL_SIZE) g_large_pool;
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1) && (NCONFIG_EVENT_USE_HEAP == 0)
+#define CACHE_POOL_SIZE                 64u
+#define CACHE_TRANSFERS                 100000u
+
+static struct test_cache_pool npool(struct nevent, CACHE_POOL_SIZE)
+        g_cache_pool;
+static struct test_cache_queue nlqueue_spsc(void *, 16) g_cache_queue;
+#endif
+
+#if (NCONFIG_EVENT_USE_HEAP == 1)
+#define HEAP_POOL_SIZE                  4u
+
+union test_block_32
+{
+    struct nevent event;
+    uint8_t bytes[32];
+};
+
+union test_block_64
+{
+    struct nevent event;
+    uint8_t bytes[64];
+};
+
+union test_block_256
+{
+    struct nevent event;
+    uint8_t bytes[256];
+};
+
+static struct test_pool_32 npool(union test_block_32, HEAP_POOL_SIZE)
+        g_pool_32;
+static struct test_pool_64 npool(union test_block_64, HEAP_POOL_SIZE)
+        g_pool_64;
+static struct test_pool_256 npool(union test_block_256, HEAP_POOL_SIZE)
+        g_pool_256;
+#endif
+
+#if (NCONFIG_EVENT_USE_HEAP == 0)
+NTESTSUITE_TEST(test_none_create)
+{
+    struct nevent * event;
+
+    event = nevent_create(NMEM_POOL(&g_pool), NEVENT_USER_ID);
+
+    ntestsuite_not_expect_ptr(NULL);
+    ntestsuite_actual_ptr(event);
+    ntestsuite_expect_uint(NEVENT_USER_ID);
+    ntestsuite_actual_uint(event->id);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(event->ref);
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+}
+
+NTESTSUITE_TEST(test_none_delete)
+{
+    struct nevent * event;
+
+    event = nevent_create(NMEM_POOL(&g_pool), NEVENT_USER_ID);
+    nevent_ref_up(event);
+    nevent_ref_up(event);
+    nevent_delete(event);
+
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+    nevent_delete(event);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+}
+
+#endif
+
+NTESTSUITE_TEST(test_none_static_event)
+{
+    const struct nevent * event = nsm_signal(NSIGNAL_AFTER);
+
+    nevent_ref_up(event);
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(nevent_ref_down(event));
+    nevent_delete(event);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+}
+
+#if (NCONFIG_EVENT_USE_HEAP == 0)
+static void * ref_thread(void * arg)
+{
+    const struct nevent * event = arg;
+
+    for (uint32_t i = 0u; i < REF_ROUNDS; i++) {
+        nevent_ref_up(event);
+        nevent_ref_down(event);
+    }
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_none_concurrent_ref)
+{
+    pthread_t threads[REF_THREADS];
+    struct nevent * event;
+
+    event = nevent_create(NMEM_POOL(&g_pool), NEVENT_USER_ID);
+    nevent_ref_up(event);
+
+    for (uint32_t i = 0u; i < REF_THREADS; i++) {
+        pthread_create(&threads[i], NULL, ref_thread, event);
+    }
+
+    for (uint32_t i = 0u; i < REF_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(event->ref);
+    nevent_delete(event);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+}
+
+#endif
+
+static void * pool_thread(void * arg)
+{
+    uint32_t owner = (uint32_t)(uintptr_t)arg;
+    uint32_t mismatches = 0u;
+
+    for (uint32_t i = 0u; i < POOL_ROUNDS; i++) {
+        uint32_t * mem = nmem_pool_alloc(NMEM_POOL(&g_pool));
+
+        if (mem == NULL) {
+            continue;
+        }
+        /* No other thread may get the same element until it is freed.
+         */
+        mem[1] = owner;
+        sched_yield();
+
+        if (mem[1] != owner) {
+            mismatches++;
+        }
+        nmem_pool_free(NMEM_POOL(&g_pool), mem);
+    }
+    return (void *)(uintptr_t)mismatches;
+}
+
+NTESTSUITE_TEST(test_none_concurrent_pool)
+{
+    pthread_t threads[REF_THREADS];
+    uint32_t mismatches = 0u;
+
+    for (uint32_t i = 0u; i < REF_THREADS; i++) {
+        pthread_create(&threads[i], NULL, pool_thread, (void *)(uintptr_t)i);
+    }
+
+    for (uint32_t i = 0u; i < REF_THREADS; i++) {
+        void * result;
+
+        pthread_join(threads[i], &result);
+        mismatches += (uint32_t)(uintptr_t)result;
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(mismatches);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+}
+
+NTESTSUITE_TEST(test_none_aligned_pool)
+{
+    uintptr_t previous = 0u;
+
+    NMEM_POOL_INIT(&g_aligned_pool);
+
+    for (uint32_t i = 0u; i < 4u; i++) {
+        uintptr_t mem = (uintptr_t)nmem_pool_alloc(NMEM_POOL(&g_aligned_pool));
+
+        ntestsuite_expect_uint(0u);
+        ntestsuite_actual_uint(mem % NMEM_POOL_ALIGN);
+        ntestsuite_expect_bool(true);
+        ntestsuite_actual_bool((mem - previous) >= NMEM_POOL_ALIGN);
+        previous = mem;
+    }
+}
+
+#if (NCONFIG_MEMPOOL_USE_MAPPED == 1)
+NTESTSUITE_TEST(test_none_mapped_pool)
+{
+    struct nmem_pool pool;
+    uint32_t allocated = 0u;
+
+    ntestsuite_expect_uint(EOK);
+    ntestsuite_actual_uint(nmem_pool_init_mapped(&pool, 24u, MAPPED_POOL_SIZE,
+            NOS_MEM_HUGE_PAGES));
+
+    for (;;) {
+        uintptr_t mem = (uintptr_t)nmem_pool_alloc(&pool);
+
+        if (mem == 0u) {
+            break;
+        }
+        ntestsuite_expect_uint(0u);
+        ntestsuite_actual_uint(mem % NMEM_POOL_ALIGN);
+        allocated++;
+    }
+    ntestsuite_expect_uint(MAPPED_POOL_SIZE);
+    ntestsuite_actual_uint(allocated);
+}
+
+NTESTSUITE_TEST(test_none_mapped_huge_aligned)
+{
+    void * mem = nos_mem_map(1u, NOS_MEM_HUGE_PAGES);
+
+    /* Both the huge page and the fallback mapping start on a 2 MB boundary.
+     */
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(mem != NULL);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint((uintptr_t)mem % (2u * 1024u * 1024u));
+    nos_mem_unmap(mem, 1u, NOS_MEM_HUGE_PAGES);
+}
+
+NTESTSUITE_TEST(test_none_mapped_pool_errors)
+{
+    struct nmem_pool pool;
+
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nmem_pool_init_mapped(&pool, SIZE_MAX / 2u, 4u,
+            0u));
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nmem_pool_init_mapped(&pool, SIZE_MAX, 1u, 0u));
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nmem_pool_init_mapped(&pool, 24u, 0u, 0u));
+}
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_LOCK_FREE == 1)
+NTESTSUITE_TEST(test_none_large_pool)
+{
+    uint32_t allocated = 0u;
+    uint32_t out_of_range = 0u;
+    uint32_t * last = NULL;
+
+    /* Only the elements which have a 16-bit index are used.
+     */
+    NMEM_POOL_INIT(&g_large_pool);
+
+    for (;;) {
+        uint32_t * mem = nmem_pool_alloc(NMEM_POOL(&g_large_pool));
+
+        if (mem == NULL) {
+            break;
+        }
+        if (mem >= &g_large_pool.storage[LARGE_POOL_LIMIT]) {
+            out_of_range++;
+        }
+        last = mem;
+        allocated++;
+    }
+    ntestsuite_expect_uint(LARGE_POOL_LIMIT);
+    ntestsuite_actual_uint(allocated);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(out_of_range);
+    nmem_pool_free(NMEM_POOL(&g_large_pool), last);
+    ntestsuite_expect_ptr(last);
+    ntestsuite_actual_ptr(nmem_pool_alloc(NMEM_POOL(&g_large_pool)));
+}
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+NTESTSUITE_TEST(test_none_lazy_pool)
+{
+    void * first;
+
+    /* Never used blocks are handed out in storage order.
+     */
+    first = nmem_pool_alloc(NMEM_POOL(&g_pool));
+    ntestsuite_expect_ptr(&g_pool.storage[0]);
+    ntestsuite_actual_ptr(first);
+    ntestsuite_expect_ptr(&g_pool.storage[1]);
+    ntestsuite_actual_ptr(nmem_pool_alloc(NMEM_POOL(&g_pool)));
+    ntestsuite_expect_ptr(NULL);
+    ntestsuite_actual_ptr(nmem_pool_alloc(NMEM_POOL(&g_pool)));
+    nmem_pool_free(NMEM_POOL(&g_pool), first);
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+    ntestsuite_expect_ptr(first);
+    ntestsuite_actual_ptr(nmem_pool_alloc(NMEM_POOL(&g_pool)));
+}
+#endif
+
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1) && (NCONFIG_EVENT_USE_HEAP == 0)
+NTESTSUITE_TEST(test_none_cache)
+{
+    struct nmem_cache cache;
+    struct nevent * event;
+
+    nmem_cache_attach(&cache, NMEM_POOL(&g_pool));
+    event = nevent_create(NMEM_POOL(&g_pool), NEVENT_USER_ID);
+    nevent_ref_up(event);
+    ntestsuite_not_expect_ptr(NULL);
+    ntestsuite_actual_ptr(event);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(cache.count);
+    nevent_delete(event);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+    nmem_cache_detach(&cache);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+
+    /* Without attached cache the pool is used directly.
+     */
+    event = nevent_create(NMEM_POOL(&g_pool), NEVENT_USER_ID);
+    nevent_ref_up(event);
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+    nevent_delete(event);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_pool.mem_pool.free);
+}
+
+static void * cache_producer(void * arg)
+{
+    struct nmem_cache cache;
+
+    (void)arg;
+    nmem_cache_attach(&cache, NMEM_POOL(&g_cache_pool));
+
+    for (uint32_t i = 0u; i < CACHE_TRANSFERS; i++) {
+        struct nevent * event;
+
+        while (NLQUEUE_SPSC_IS_FULL(&g_cache_queue)) {
+            sched_yield();
+        }
+
+        while ((event = nevent_create(NMEM_POOL(&g_cache_pool),
+                NEVENT_USER_ID)) == NULL) {
+            sched_yield();
+        }
+        nevent_ref_up(event);
+        NLQUEUE_SPSC_PUT(&g_cache_queue, event);
+    }
+    nmem_cache_detach(&cache);
+
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_none_cache_threads)
+{
+    struct nmem_cache cache;
+    pthread_t producer;
+
+    NMEM_POOL_INIT(&g_cache_pool);
+    NLQUEUE_SPSC_INIT(&g_cache_queue);
+    nmem_cache_attach(&cache, NMEM_POOL(&g_cache_pool));
+    pthread_create(&producer, NULL, cache_producer, NULL);
+
+    /* Events are allocated by the producer and freed by this thread.
+     */
+    for (uint32_t i = 0u; i < CACHE_TRANSFERS; i++) {
+        void * event;
+
+        while (NLQUEUE_SPSC_IS_EMPTY(&g_cache_queue)) {
+            sched_yield();
+        }
+        NLQUEUE_SPSC_GET(&g_cache_queue, event);
+        nevent_delete(event);
+    }
+    pthread_join(producer, NULL);
+    nmem_cache_detach(&cache);
+    ntestsuite_expect_uint(CACHE_POOL_SIZE);
+    ntestsuite_actual_uint(g_cache_pool.mem_pool.free);
+}
+#endif
+
+#if (NCONFIG_EVENT_USE_HEAP == 1)
+NTESTSUITE_TEST(test_heap_class)
+{
+    const struct nevent * event;
+
+    event = nevent_create(sizeof(struct nevent), NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NMEM_POOL(&g_pool_32));
+    ntestsuite_actual_ptr(event->pool);
+    ntestsuite_expect_uint(NEVENT_USER_ID);
+    ntestsuite_actual_uint(event->id);
+    event = nevent_create(32u, NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NMEM_POOL(&g_pool_32));
+    ntestsuite_actual_ptr(event->pool);
+    event = nevent_create(33u, NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NMEM_POOL(&g_pool_64));
+    ntestsuite_actual_ptr(event->pool);
+    event = nevent_create(64u, NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NMEM_POOL(&g_pool_64));
+    ntestsuite_actual_ptr(event->pool);
+    event = nevent_create(65u, NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NMEM_POOL(&g_pool_256));
+    ntestsuite_actual_ptr(event->pool);
+    event = nevent_create(257u, NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NULL);
+    ntestsuite_actual_ptr(event);
+}
+
+NTESTSUITE_TEST(test_heap_exhausted)
+{
+    const struct nevent * event;
+
+    for (uint32_t i = 0u; i < HEAP_POOL_SIZE; i++) {
+        (void)nevent_create(32u, NEVENT_USER_ID);
+    }
+    /* The next larger class takes over when the class pool is exhausted.
+     */
+    event = nevent_create(32u, NEVENT_USER_ID);
+    ntestsuite_expect_ptr(NMEM_POOL(&g_pool_64));
+    ntestsuite_actual_ptr(event->pool);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(g_pool_32.mem_pool.free);
+    ntestsuite_expect_uint(HEAP_POOL_SIZE - 1u);
+    ntestsuite_actual_uint(g_pool_64.mem_pool.free);
+}
+
+NTESTSUITE_TEST(test_heap_delete)
+{
+    const struct nevent * event;
+
+    event = nevent_create(100u, NEVENT_USER_ID);
+    nevent_ref_up(event);
+    ntestsuite_expect_uint(HEAP_POOL_SIZE - 1u);
+    ntestsuite_actual_uint(g_pool_256.mem_pool.free);
+    nevent_delete(event);
+    ntestsuite_expect_uint(HEAP_POOL_SIZE);
+    ntestsuite_actual_uint(g_pool_256.mem_pool.free);
+}
+#endif
+
+static void setup_none(void)
+{
+    NMEM_POOL_INIT(&g_pool);
+}
+
+#if (NCONFIG_EVENT_USE_HEAP == 1)
+static void setup_heap(void)
+{
+    NMEM_POOL_INIT(&g_pool_32);
+    NMEM_POOL_INIT(&g_pool_64);
+    NMEM_POOL_INIT(&g_pool_256);
+    /* Register in no particular order, registering a pool again changes
+     * nothing.
+     */
+    nevent_heap_register(NMEM_POOL(&g_pool_256));
+    nevent_heap_register(NMEM_POOL(&g_pool_32));
+    nevent_heap_register(NMEM_POOL(&g_pool_64));
+}
+#endif
+
+void test_exec_nevent(void)
+{
+    ntestsuite_set_fixture(none, setup_none, NULL);
+#if (NCONFIG_EVENT_USE_HEAP == 0)
+    ntestsuite_run(test_none_create);
+    ntestsuite_run(test_none_delete);
+#endif
+    ntestsuite_run(test_none_static_event);
+#if (NCONFIG_EVENT_USE_HEAP == 0)
+    ntestsuite_run(test_none_concurrent_ref);
+#endif
+    ntestsuite_run(test_none_concurrent_pool);
+    ntestsuite_run(test_none_aligned_pool);
+#if (NCONFIG_MEMPOOL_USE_MAPPED == 1)
+    ntestsuite_run(test_none_mapped_pool);
+    ntestsuite_run(test_none_mapped_huge_aligned);
+    ntestsuite_run(test_none_mapped_pool_errors);
+#endif
+#if (NCONFIG_MEMPOOL_USE_LOCK_FREE == 1)
+    ntestsuite_run(test_none_large_pool);
+#endif
+#if (NCONFIG_MEMPOOL_USE_LAZY_INIT == 1)
+    ntestsuite_run(test_none_lazy_pool);
+#endif
+#if (NCONFIG_MEMPOOL_USE_CACHE == 1) && (NCONFIG_EVENT_USE_HEAP == 0)
+    ntestsuite_run(test_none_cache);
+    ntestsuite_run(test_none_cache_threads);
+#endif
+
+#if (NCONFIG_EVENT_USE_HEAP == 1)
+    ntestsuite_set_fixture(heap, setup_heap, NULL);
+    ntestsuite_run(test_heap_class);
+    ntestsuite_run(test_heap_exhausted);
+    ntestsuite_run(test_heap_delete);
+#endif
+}
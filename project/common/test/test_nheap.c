@@ -0,0 +1,273 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+/* The benchmark timing uses the POSIX CPU time clock, on other hosts only
+ * the benchmark ordering is checked.
+ */
+#if defined(__unix__)
+#define _POSIX_C_SOURCE                 200809L
+#define BENCH_USE_CPU_TIME              1
+#else
+#define BENCH_USE_CPU_TIME              0
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (BENCH_USE_CPU_TIME == 1)
+#include <stdio.h>
+#include <time.h>
+#endif
+
+#include "../testsuite/ntestsuite.h"
+#include "core/nheap.h"
+#include "core/npqueue.h"
+#include "test_nheap.h"
+
+#define BENCH_NODES                     256u
+#define BENCH_ROUNDS                    200000u
+
+struct test_node
+{
+    struct nheap_node heap_node;
+    struct npqueue pqueue_node;
+    uint32_t id;
+};
+
+static struct test_heap nheap(BENCH_NODES) g_heap;
+static struct npqueue_sentinel g_sentinel;
+static struct test_node g_nodes[BENCH_NODES];
+static uint32_t g_random;
+
+static struct test_node * node_from_heap(struct nheap_node * node)
+{
+    return NPLATFORM_CONTAINER_OF(node, struct test_node, heap_node);
+}
+
+static uint32_t random_next(void)
+{
+    g_random = g_random * 1664525u + 1013904223u;
+
+    return g_random >> 8;
+}
+
+#if (BENCH_USE_CPU_TIME == 1)
+static uint64_t cpu_time_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+#else
+static uint64_t cpu_time_ns(void)
+{
+    return 0u;
+}
+#endif
+
+NTESTSUITE_TEST(test_empty_is_empty)
+{
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NHEAP_IS_EMPTY(&g_heap));
+}
+
+/* The children of each entry start on a 4 entry boundary of the aligned heap
+ * array.
+ */
+NTESTSUITE_TEST(test_empty_sibling_alignment)
+{
+    uint32_t errors = 0u;
+
+    for (uint32_t i = 0u; (4u * i + 1u) < BENCH_NODES; i++) {
+        uintptr_t offset = (uintptr_t)&g_heap.super.entries[4u * i + 1u] -
+                (uintptr_t)&g_heap.np_heap_storage[0];
+
+        if ((offset % (4u * sizeof(struct nheap_entry))) != 0u) {
+            errors++;
+        }
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(errors);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(
+            (uintptr_t)&g_heap.np_heap_storage[0] % NARCH_CACHE_LINE);
+}
+
+NTESTSUITE_TEST(test_empty_remove_order)
+{
+    static const uint32_t keys[] = { 50u, 10u, 40u, 10u, 30u, 20u, 60u };
+    uint32_t previous = 0u;
+    uint32_t order_errors = 0u;
+
+    for (uint32_t i = 0u; i < NBITS_ARRAY_SIZE(keys); i++) {
+        NHEAP_INSERT(&g_heap, &g_nodes[i].heap_node, keys[i]);
+    }
+    ntestsuite_expect_uint(NBITS_ARRAY_SIZE(keys));
+    ntestsuite_actual_uint(NHEAP_COUNT(&g_heap));
+
+    while (!NHEAP_IS_EMPTY(&g_heap)) {
+        uint32_t key = NHEAP_HEAD_KEY(&g_heap);
+        struct test_node * node = node_from_heap(NHEAP_REMOVE_HEAD(&g_heap));
+
+        if ((key < previous) || (keys[node->id] != key)) {
+            order_errors++;
+        }
+        previous = key;
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(order_errors);
+}
+
+NTESTSUITE_TEST(test_empty_wrapping_keys)
+{
+    /* The key 5 is a deadline after the counter has wrapped around.
+     */
+    NHEAP_INSERT(&g_heap, &g_nodes[0].heap_node, 5u);
+    NHEAP_INSERT(&g_heap, &g_nodes[1].heap_node, UINT32_MAX - 5u);
+    ntestsuite_expect_ptr(&g_nodes[1].heap_node);
+    ntestsuite_actual_ptr(NHEAP_HEAD(&g_heap));
+}
+
+NTESTSUITE_TEST(test_nonempty_decrease_key)
+{
+    NHEAP_DECREASE_KEY(&g_heap, &g_nodes[5].heap_node, 1u);
+    ntestsuite_expect_ptr(&g_nodes[5].heap_node);
+    ntestsuite_actual_ptr(NHEAP_HEAD(&g_heap));
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(NHEAP_KEY(&g_heap, &g_nodes[5].heap_node));
+}
+
+NTESTSUITE_TEST(test_nonempty_remove)
+{
+    uint32_t order_errors = 0u;
+
+    /* Remove the head, a leaf and an inner node.
+     */
+    NHEAP_REMOVE(&g_heap, &g_nodes[0].heap_node);
+    NHEAP_REMOVE(&g_heap, &g_nodes[BENCH_NODES - 1u].heap_node);
+    NHEAP_REMOVE(&g_heap, &g_nodes[3].heap_node);
+    ntestsuite_expect_uint(BENCH_NODES - 3u);
+    ntestsuite_actual_uint(NHEAP_COUNT(&g_heap));
+
+    for (uint32_t expected = 1u; !NHEAP_IS_EMPTY(&g_heap); expected++) {
+        struct test_node * node = node_from_heap(NHEAP_REMOVE_HEAD(&g_heap));
+
+        if ((expected == 3u) || (expected == (BENCH_NODES - 1u))) {
+            expected++;
+        }
+        if (node->id != expected) {
+            order_errors++;
+        }
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(order_errors);
+}
+
+NTESTSUITE_TEST(test_nonempty_insert_full)
+{
+    static struct test_node extra;
+
+    ntestsuite_expect_int(-EOBJ_INVALID);
+    ntestsuite_actual_int(NHEAP_INSERT(&g_heap, &extra.heap_node, 5u));
+    ntestsuite_expect_uint(BENCH_NODES);
+    ntestsuite_actual_uint(NHEAP_COUNT(&g_heap));
+    ntestsuite_expect_uint(10u);
+    ntestsuite_actual_uint(NHEAP_HEAD_KEY(&g_heap));
+}
+
+/* Both queues hold the same number of nodes. Each round removes the first
+ * node and inserts it again with a new random priority, like a deadline
+ * queue does.
+ */
+NTESTSUITE_TEST(test_nonempty_benchmark)
+{
+    uint64_t heap_ns;
+    uint64_t pqueue_ns;
+    uint32_t now = 0u;
+    uint32_t order_errors = 0u;
+
+    npqueue_sentinel_init(&g_sentinel);
+
+    for (uint32_t i = 0u; i < BENCH_NODES; i++) {
+        npqueue_init(&g_nodes[i].pqueue_node,
+                (uint_fast8_t)(random_next() % NCONFIG_PQUEUE_PRIORITIES));
+        npqueue_insert_sort(&g_sentinel, &g_nodes[i].pqueue_node);
+    }
+    heap_ns = cpu_time_ns();
+
+    for (uint32_t i = 0u; i < BENCH_ROUNDS; i++) {
+        uint32_t key = NHEAP_HEAD_KEY(&g_heap);
+        struct nheap_node * node = NHEAP_REMOVE_HEAD(&g_heap);
+
+        if (key < now) {
+            order_errors++;
+        }
+        now = key;
+        NHEAP_INSERT(&g_heap, node, now + (random_next() & 0xffffu));
+    }
+    heap_ns = cpu_time_ns() - heap_ns;
+    pqueue_ns = cpu_time_ns();
+
+    for (uint32_t i = 0u; i < BENCH_ROUNDS; i++) {
+        struct npqueue * node = npqueue_sentinel_head(&g_sentinel);
+
+        npqueue_remove(&g_sentinel, node);
+        npqueue_priority_set(node,
+                (uint_fast8_t)(random_next() % NCONFIG_PQUEUE_PRIORITIES));
+        npqueue_insert_sort(&g_sentinel, node);
+    }
+    pqueue_ns = cpu_time_ns() - pqueue_ns;
+#if (BENCH_USE_CPU_TIME == 1)
+    printf("Benchmark, %u nodes: nheap %u ns/op, npqueue %u ns/op\n",
+            (unsigned)BENCH_NODES,
+            (unsigned)(heap_ns / BENCH_ROUNDS),
+            (unsigned)(pqueue_ns / BENCH_ROUNDS));
+#else
+    (void)heap_ns;
+    (void)pqueue_ns;
+#endif
+
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(order_errors);
+}
+
+static void setup_empty(void)
+{
+    NHEAP_INIT(&g_heap);
+
+    for (uint32_t i = 0u; i < BENCH_NODES; i++) {
+        g_nodes[i].id = i;
+    }
+}
+
+static void setup_nonempty(void)
+{
+    NHEAP_INIT(&g_heap);
+    g_random = 1u;
+
+    for (uint32_t i = 0u; i < BENCH_NODES; i++) {
+        g_nodes[i].id = i;
+        NHEAP_INSERT(&g_heap, &g_nodes[i].heap_node, (i + 1u) * 10u);
+    }
+}
+
+void test_exec_nheap(void)
+{
+    ntestsuite_set_fixture(empty, setup_empty, NULL);
+    ntestsuite_run(test_empty_is_empty);
+    ntestsuite_run(test_empty_sibling_alignment);
+    ntestsuite_run(test_empty_remove_order);
+    ntestsuite_run(test_empty_wrapping_keys);
+
+    ntestsuite_set_fixture(nonempty, setup_nonempty, NULL);
+    ntestsuite_run(test_nonempty_decrease_key);
+    ntestsuite_run(test_nonempty_remove);
+    ntestsuite_run(test_nonempty_insert_full);
+    ntestsuite_run(test_nonempty_benchmark);
+}
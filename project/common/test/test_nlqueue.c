@@ -8,6 +8,8 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 #include "test_nlqueue.h"
 
 #include "../testsuite/ntestsuite.h"
@@ -15,7 +17,31 @@
 
 #define QUEUE_SIZE 4
 
+#define SPSC_TRANSFERS 10000u
+
+#define BROADCAST_READERS 2u
+#define BROADCAST_TRANSFERS 10000u
+
+#if (NCONFIG_LQUEUE_USE_LARGE == 1)
+#define LARGE_QUEUE_SIZE 65536
+#else
+#define LARGE_QUEUE_SIZE 256
+#endif
+
 static struct test_queue nlqueue(uint8_t, QUEUE_SIZE) g_test_queue;
+static struct test_spsc_queue nlqueue_spsc(uint32_t, QUEUE_SIZE) g_test_spsc;
+static struct test_large_queue nlqueue(uint32_t, LARGE_QUEUE_SIZE) g_test_large;
+static struct test_broadcast_queue nlqueue_broadcast(uint32_t, QUEUE_SIZE)
+        g_test_broadcast;
+static struct nlqueue_reader g_test_readers[BROADCAST_READERS];
+
+#if (NCONFIG_LQUEUE_USE_WAIT == 1)
+#define WAIT_TRANSFERS 10000u
+
+static struct test_wait_storage nlqueue_storage(uint32_t, QUEUE_SIZE)
+        g_test_wait_storage;
+static struct test_wait_queue nlqueue_wait_dynamic(uint32_t) g_test_wait;
+#endif
 
 NTESTSUITE_TEST(test_none_init)
 {
@@ -158,6 +184,430 @@ NTESTSUITE_TEST(test_full_is_empty)
     ntestsuite_actual_bool(NLQUEUE_IS_EMPTY(&g_test_queue));
 }
 
+NTESTSUITE_TEST(test_nonempty_put_n_wrap)
+{
+    static const uint8_t items[] = { 3, 4 };
+    uint8_t got[4];
+
+    /* The queue holds items at indices 1 and 2, so the put wraps around.
+     */
+    NLQUEUE_PUT_N(&g_test_queue, items, 2u);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(NLQUEUE_EMPTY(&g_test_queue));
+    NLQUEUE_GET_N(&g_test_queue, got, 4u);
+    ntestsuite_expect_uint(1234u);
+    ntestsuite_actual_uint(got[0] * 1000u + got[1] * 100u + got[2] * 10u +
+            got[3]);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_IS_EMPTY(&g_test_queue));
+}
+
+NTESTSUITE_TEST(test_nonempty_reserve_put)
+{
+    uint8_t * region;
+    uint_fast16_t count;
+    uint_fast16_t regions = 0u;
+    uint8_t item = 3u;
+    uint32_t got = 0u;
+
+    /* The free space wraps around, so it is reserved in at most two regions
+     * which end at the queue buffer end.
+     */
+    for (;;) {
+        region = NLQUEUE_PUT_RESERVE(&g_test_queue, count);
+
+        if (count == 0u) {
+            break;
+        }
+        ntestsuite_expect_bool(true);
+        ntestsuite_actual_bool(
+                (region + count) <= &g_test_queue.np_lq_storage[QUEUE_SIZE]);
+
+        for (uint_fast16_t i = 0u; i < count; i++) {
+            region[i] = item++;
+        }
+        NLQUEUE_PUT_COMMIT(&g_test_queue, count);
+        regions++;
+    }
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(regions <= 2u);
+    ntestsuite_expect_uint(4u);
+    ntestsuite_actual_uint(NLQUEUE_TAIL(&g_test_queue));
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_IS_FULL(&g_test_queue));
+
+    while (!NLQUEUE_IS_EMPTY(&g_test_queue)) {
+        got = got * 10u + NLQUEUE_GET(&g_test_queue);
+    }
+    ntestsuite_expect_uint(1234u);
+    ntestsuite_actual_uint(got);
+}
+
+NTESTSUITE_TEST(test_full_reserve_get)
+{
+    const uint8_t * region;
+    uint_fast16_t count;
+    uint_fast16_t regions = 0u;
+    uint32_t got = 0u;
+
+    for (;;) {
+        region = NLQUEUE_GET_RESERVE(&g_test_queue, count);
+
+        if (count == 0u) {
+            break;
+        }
+        for (uint_fast16_t i = 0u; i < count; i++) {
+            got = got * 10u + region[i];
+        }
+        NLQUEUE_GET_COMMIT(&g_test_queue, count);
+        regions++;
+    }
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(regions <= 2u);
+    ntestsuite_expect_uint(1234u);
+    ntestsuite_actual_uint(got);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_IS_EMPTY(&g_test_queue));
+}
+
+NTESTSUITE_TEST(test_spsc_is_empty)
+{
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_SPSC_IS_EMPTY(&g_test_spsc));
+}
+
+NTESTSUITE_TEST(test_spsc_size)
+{
+    ntestsuite_expect_uint(QUEUE_SIZE);
+    ntestsuite_actual_uint(NLQUEUE_SPSC_SIZE(&g_test_spsc));
+}
+
+NTESTSUITE_TEST(test_spsc_is_full)
+{
+    for (uint32_t i = 0u; i < QUEUE_SIZE; i++) {
+        ntestsuite_expect_bool(false);
+        ntestsuite_actual_bool(NLQUEUE_SPSC_IS_FULL(&g_test_spsc));
+        NLQUEUE_SPSC_PUT(&g_test_spsc, i);
+    }
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_SPSC_IS_FULL(&g_test_spsc));
+}
+
+NTESTSUITE_TEST(test_spsc_fifo_wrap)
+{
+    uint32_t item;
+
+    /* Move the indices around the buffer end a few times.
+     */
+    for (uint32_t i = 0u; i < (QUEUE_SIZE * 3u); i++) {
+        NLQUEUE_SPSC_PUT(&g_test_spsc, i);
+        NLQUEUE_SPSC_PUT(&g_test_spsc, i + 100u);
+        ntestsuite_expect_bool(false);
+        ntestsuite_actual_bool(NLQUEUE_SPSC_IS_EMPTY(&g_test_spsc));
+        NLQUEUE_SPSC_GET(&g_test_spsc, item);
+        ntestsuite_expect_uint(i);
+        ntestsuite_actual_uint(item);
+        ntestsuite_expect_bool(false);
+        ntestsuite_actual_bool(NLQUEUE_SPSC_IS_EMPTY(&g_test_spsc));
+        NLQUEUE_SPSC_GET(&g_test_spsc, item);
+        ntestsuite_expect_uint(i + 100u);
+        ntestsuite_actual_uint(item);
+    }
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_SPSC_IS_EMPTY(&g_test_spsc));
+}
+
+static void * spsc_producer(void * arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 0u; i < SPSC_TRANSFERS; i++) {
+        while (NLQUEUE_SPSC_IS_FULL(&g_test_spsc)) {
+            sched_yield();
+        }
+        NLQUEUE_SPSC_PUT(&g_test_spsc, i);
+    }
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_spsc_threads)
+{
+    pthread_t producer;
+    uint32_t mismatches = 0u;
+
+    pthread_create(&producer, NULL, spsc_producer, NULL);
+
+    for (uint32_t i = 0u; i < SPSC_TRANSFERS; i++) {
+        uint32_t item;
+
+        while (NLQUEUE_SPSC_IS_EMPTY(&g_test_spsc)) {
+            sched_yield();
+        }
+        NLQUEUE_SPSC_GET(&g_test_spsc, item);
+
+        if (item != i) {
+            mismatches++;
+        }
+    }
+    pthread_join(producer, NULL);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(mismatches);
+}
+
+NTESTSUITE_TEST(test_broadcast_readers)
+{
+    uint32_t item;
+    bool is_got;
+
+    NLQUEUE_BROADCAST_PUT(&g_test_broadcast, 1u, is_got);
+    NLQUEUE_BROADCAST_PUT(&g_test_broadcast, 2u, is_got);
+
+    for (uint32_t r = 0u; r < BROADCAST_READERS; r++) {
+        NLQUEUE_BROADCAST_GET(&g_test_broadcast, &g_test_readers[r], item,
+                is_got);
+        ntestsuite_expect_uint(1u);
+        ntestsuite_actual_uint(item);
+        NLQUEUE_BROADCAST_GET(&g_test_broadcast, &g_test_readers[r], item,
+                is_got);
+        ntestsuite_expect_uint(2u);
+        ntestsuite_actual_uint(item);
+        NLQUEUE_BROADCAST_GET(&g_test_broadcast, &g_test_readers[r], item,
+                is_got);
+        ntestsuite_expect_bool(false);
+        ntestsuite_actual_bool(is_got);
+        ntestsuite_expect_bool(true);
+        ntestsuite_actual_bool(NLQUEUE_BROADCAST_IS_EMPTY(&g_test_broadcast,
+                &g_test_readers[r]));
+    }
+}
+
+NTESTSUITE_TEST(test_broadcast_gating)
+{
+    uint32_t item;
+    bool is_put;
+
+    for (uint32_t i = 0u; i < QUEUE_SIZE; i++) {
+        NLQUEUE_BROADCAST_PUT(&g_test_broadcast, i, is_put);
+        ntestsuite_expect_bool(true);
+        ntestsuite_actual_bool(is_put);
+    }
+    /* The queue stays full until the slowest gating reader gets an item.
+     */
+    NLQUEUE_BROADCAST_GET(&g_test_broadcast, &g_test_readers[0], item, is_put);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(item);
+    NLQUEUE_BROADCAST_PUT(&g_test_broadcast, 100u, is_put);
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(is_put);
+    NLQUEUE_BROADCAST_GET(&g_test_broadcast, &g_test_readers[1], item, is_put);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(item);
+    NLQUEUE_BROADCAST_PUT(&g_test_broadcast, 100u, is_put);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(is_put);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_BROADCAST_IS_FULL(&g_test_broadcast));
+}
+
+NTESTSUITE_TEST(test_broadcast_lossy)
+{
+    struct nlqueue_reader lossy;
+    uint32_t item;
+    bool is_got;
+
+    NLQUEUE_BROADCAST_UNSUBSCRIBE(&g_test_broadcast, &g_test_readers[0]);
+    NLQUEUE_BROADCAST_UNSUBSCRIBE(&g_test_broadcast, &g_test_readers[1]);
+    NLQUEUE_BROADCAST_SUBSCRIBE(&g_test_broadcast, &lossy, true);
+
+    for (uint32_t i = 0u; i < 10u; i++) {
+        NLQUEUE_BROADCAST_PUT(&g_test_broadcast, i, is_got);
+        ntestsuite_expect_bool(true);
+        ntestsuite_actual_bool(is_got);
+    }
+    /* While the producer writes the next item, only size - 1 items are
+     * readable.
+     */
+    for (uint32_t i = 10u - QUEUE_SIZE + 1u; i < 10u; i++) {
+        NLQUEUE_BROADCAST_GET(&g_test_broadcast, &lossy, item, is_got);
+        ntestsuite_expect_bool(true);
+        ntestsuite_actual_bool(is_got);
+        ntestsuite_expect_uint(i);
+        ntestsuite_actual_uint(item);
+    }
+    ntestsuite_expect_uint(10u - QUEUE_SIZE + 1u);
+    ntestsuite_actual_uint(lossy.lost);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_BROADCAST_IS_EMPTY(&g_test_broadcast,
+            &lossy));
+}
+
+static void * broadcast_reader(void * arg)
+{
+    struct nlqueue_reader * reader = arg;
+    uint32_t mismatches = 0u;
+    uint32_t expected = 0u;
+
+    while (expected < BROADCAST_TRANSFERS) {
+        uint32_t item;
+        bool is_got;
+
+        NLQUEUE_BROADCAST_GET(&g_test_broadcast, reader, item, is_got);
+
+        if (!is_got) {
+            sched_yield();
+            continue;
+        }
+        /* A lossy reader may skip items, but never goes back.
+         */
+        if (reader->is_lossy ? (item < expected) : (item != expected)) {
+            mismatches++;
+        }
+        expected = item + 1u;
+    }
+    return (void *)(uintptr_t)mismatches;
+}
+
+NTESTSUITE_TEST(test_broadcast_threads)
+{
+    struct nlqueue_reader lossy;
+    pthread_t readers[BROADCAST_READERS + 1u];
+    uint32_t mismatches = 0u;
+
+    NLQUEUE_BROADCAST_SUBSCRIBE(&g_test_broadcast, &lossy, true);
+
+    for (uint32_t r = 0u; r < BROADCAST_READERS; r++) {
+        pthread_create(&readers[r], NULL, broadcast_reader,
+                &g_test_readers[r]);
+    }
+    pthread_create(&readers[BROADCAST_READERS], NULL, broadcast_reader,
+            &lossy);
+
+    for (uint32_t i = 0u; i < BROADCAST_TRANSFERS; i++) {
+        bool is_put;
+
+        do {
+            NLQUEUE_BROADCAST_PUT(&g_test_broadcast, i, is_put);
+
+            if (!is_put) {
+                sched_yield();
+            }
+        } while (!is_put);
+    }
+
+    for (uint32_t r = 0u; r <= BROADCAST_READERS; r++) {
+        void * result;
+
+        pthread_join(readers[r], &result);
+        mismatches += (uint32_t)(uintptr_t)result;
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(mismatches);
+}
+
+NTESTSUITE_TEST(test_large_empty)
+{
+    ntestsuite_expect_uint(LARGE_QUEUE_SIZE);
+    ntestsuite_actual_uint(NLQUEUE_EMPTY(&g_test_large));
+}
+
+NTESTSUITE_TEST(test_large_fifo_overwrite)
+{
+    uint32_t mismatches = 0u;
+
+    /* Overwrite the oldest quarter of items.
+     */
+    for (uint32_t i = 0u; i < (LARGE_QUEUE_SIZE + LARGE_QUEUE_SIZE / 4u); i++) {
+        NLQUEUE_PUT_FIFO(&g_test_large, i);
+    }
+    for (uint32_t i = LARGE_QUEUE_SIZE / 4u;
+            i < (LARGE_QUEUE_SIZE + LARGE_QUEUE_SIZE / 4u); i++) {
+        if (NLQUEUE_IS_EMPTY(&g_test_large)) {
+            mismatches++;
+            break;
+        }
+        if (NLQUEUE_GET(&g_test_large) != i) {
+            mismatches++;
+        }
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(mismatches);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_IS_EMPTY(&g_test_large));
+}
+
+NTESTSUITE_TEST(test_large_lifo_full)
+{
+    uint32_t mismatches = 0u;
+
+    for (uint32_t i = 0u; i < LARGE_QUEUE_SIZE; i++) {
+        NLQUEUE_PUT_LIFO(&g_test_large, i);
+    }
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_IS_FULL(&g_test_large));
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(NLQUEUE_TAIL(&g_test_large));
+
+    for (uint32_t i = LARGE_QUEUE_SIZE; i-- > 0u;) {
+        if (NLQUEUE_GET(&g_test_large) != i) {
+            mismatches++;
+        }
+    }
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(mismatches);
+}
+
+#if (NCONFIG_LQUEUE_USE_WAIT == 1)
+NTESTSUITE_TEST(test_wait_put_get)
+{
+    uint32_t item = 0u;
+
+    NLQUEUE_WAIT_PUT(&g_test_wait, 1u);
+    NLQUEUE_WAIT_PUT_FIFO(&g_test_wait, 2u);
+    NLQUEUE_WAIT_GET(&g_test_wait, item);
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(item);
+    NLQUEUE_WAIT_GET(&g_test_wait, item);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(item);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NLQUEUE_IS_EMPTY(&g_test_wait));
+}
+
+static void * wait_producer(void * arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 0u; i < WAIT_TRANSFERS; i++) {
+        NLQUEUE_WAIT_PUT(&g_test_wait, i);
+    }
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_wait_threads)
+{
+    pthread_t producer;
+    uint32_t mismatches = 0u;
+
+    /* Both sides block: the consumer when the queue is empty and the
+     * producer when it is full.
+     */
+    pthread_create(&producer, NULL, wait_producer, NULL);
+
+    for (uint32_t i = 0u; i < WAIT_TRANSFERS; i++) {
+        uint32_t item;
+
+        NLQUEUE_WAIT_GET(&g_test_wait, item);
+
+        if (item != i) {
+            mismatches++;
+        }
+    }
+    pthread_join(producer, NULL);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(mismatches);
+}
+#endif
+
 static void setup_empty(void)
 {
     memset(&g_test_queue, 0, sizeof(g_test_queue));
@@ -182,6 +632,37 @@ static void setup_full(void)
     NLQUEUE_PUT_FIFO(&g_test_queue, 4);
 }
 
+static void setup_large(void)
+{
+    memset(&g_test_large, 0, sizeof(g_test_large));
+    NLQUEUE_INIT(&g_test_large);
+}
+
+static void setup_broadcast(void)
+{
+    memset(&g_test_broadcast, 0, sizeof(g_test_broadcast));
+    NLQUEUE_BROADCAST_INIT(&g_test_broadcast);
+
+    for (uint32_t r = 0u; r < BROADCAST_READERS; r++) {
+        NLQUEUE_BROADCAST_SUBSCRIBE(&g_test_broadcast, &g_test_readers[r],
+                false);
+    }
+}
+
+#if (NCONFIG_LQUEUE_USE_WAIT == 1)
+static void setup_wait(void)
+{
+    memset(&g_test_wait_storage, 0, sizeof(g_test_wait_storage));
+    NLQUEUE_WAIT_INIT(&g_test_wait, &g_test_wait_storage);
+}
+#endif
+
+static void setup_spsc(void)
+{
+    memset(&g_test_spsc, 0, sizeof(g_test_spsc));
+    NLQUEUE_SPSC_INIT(&g_test_spsc);
+}
+
 void test_exec_nlqueue(void)
 {
     ntestsuite_set_fixture(none, NULL, NULL);
@@ -206,10 +687,37 @@ void test_exec_nlqueue(void)
     ntestsuite_run(test_nonempty_fifo_tail);
     ntestsuite_run(test_nonempty_lifo_head);
     ntestsuite_run(test_nonempty_lifo_tail);
+    ntestsuite_run(test_nonempty_put_n_wrap);
+    ntestsuite_run(test_nonempty_reserve_put);
 
     ntestsuite_set_fixture(full, setup_full, NULL);
     ntestsuite_run(test_full_empty);
     ntestsuite_run(test_full_size);
     ntestsuite_run(test_full_is_full);
     ntestsuite_run(test_full_is_empty);
+    ntestsuite_run(test_full_reserve_get);
+
+    ntestsuite_set_fixture(large, setup_large, NULL);
+    ntestsuite_run(test_large_empty);
+    ntestsuite_run(test_large_fifo_overwrite);
+    ntestsuite_run(test_large_lifo_full);
+
+    ntestsuite_set_fixture(broadcast, setup_broadcast, NULL);
+    ntestsuite_run(test_broadcast_readers);
+    ntestsuite_run(test_broadcast_gating);
+    ntestsuite_run(test_broadcast_lossy);
+    ntestsuite_run(test_broadcast_threads);
+
+    ntestsuite_set_fixture(spsc, setup_spsc, NULL);
+    ntestsuite_run(test_spsc_is_empty);
+    ntestsuite_run(test_spsc_size);
+    ntestsuite_run(test_spsc_is_full);
+    ntestsuite_run(test_spsc_fifo_wrap);
+    ntestsuite_run(test_spsc_threads);
+
+#if (NCONFIG_LQUEUE_USE_WAIT == 1)
+    ntestsuite_set_fixture(wait, setup_wait, NULL);
+    ntestsuite_run(test_wait_put_get);
+    ntestsuite_run(test_wait_threads);
+#endif
 }
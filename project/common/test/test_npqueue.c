@@ -0,0 +1,143 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../testsuite/ntestsuite.h"
+#include "core/npqueue.h"
+#include "test_npqueue.h"
+
+struct test_node
+{
+    struct npqueue node;
+    uint32_t id;
+};
+
+static struct npqueue_sentinel g_sentinel;
+static struct test_node g_nodes[6];
+
+static void insert(uint32_t idx, uint_fast8_t priority)
+{
+    npqueue_init(&g_nodes[idx].node, priority);
+    g_nodes[idx].id = idx + 1u;
+    npqueue_insert_sort(&g_sentinel, &g_nodes[idx].node);
+}
+
+/* Returns node identifiers from queue head to tail as decimal digits.
+ */
+static uint32_t trace(void)
+{
+    struct nlist_dll * current;
+    uint32_t retval = 0u;
+
+    for (current = nlist_dll_next(&g_sentinel.list);
+         current != &g_sentinel.list;
+         current = nlist_dll_next(current)) {
+        retval = retval * 10u + NPLATFORM_CONTAINER_OF(
+                npqueue_from_list(current), struct test_node, node)->id;
+    }
+    return retval;
+}
+
+NTESTSUITE_TEST(test_empty_is_empty)
+{
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NPQUEUE_SENTINEL_IS_EMPTY(&g_sentinel));
+}
+
+NTESTSUITE_TEST(test_empty_insert_sort)
+{
+    insert(0u, 3u);
+    insert(1u, 1u);
+    insert(2u, 3u);
+    insert(3u, 7u);
+    insert(4u, 1u);
+    insert(5u, 0u);
+    ntestsuite_expect_uint(413256u);
+    ntestsuite_actual_uint(trace());
+    ntestsuite_expect_ptr(&g_nodes[3].node);
+    ntestsuite_actual_ptr(npqueue_sentinel_head(&g_sentinel));
+}
+
+NTESTSUITE_TEST(test_empty_insert_group_boundary)
+{
+    insert(0u, 31u);
+    insert(1u, 255u);
+    insert(2u, 32u);
+    insert(3u, 0u);
+    insert(4u, 200u);
+    ntestsuite_expect_uint(25314u);
+    ntestsuite_actual_uint(trace());
+}
+
+NTESTSUITE_TEST(test_nonempty_remove_tail)
+{
+    /* Removing the last node of level 3 makes the first one the tail.
+     */
+    npqueue_remove(&g_sentinel, &g_nodes[2].node);
+    insert(2u, 3u);
+    ntestsuite_expect_uint(4132u);
+    ntestsuite_actual_uint(trace());
+}
+
+NTESTSUITE_TEST(test_nonempty_remove_level)
+{
+    npqueue_remove(&g_sentinel, &g_nodes[0].node);
+    npqueue_remove(&g_sentinel, &g_nodes[2].node);
+    insert(0u, 2u);
+    ntestsuite_expect_uint(412u);
+    ntestsuite_actual_uint(trace());
+    npqueue_remove(&g_sentinel, &g_nodes[3].node);
+    npqueue_remove(&g_sentinel, &g_nodes[0].node);
+    npqueue_remove(&g_sentinel, &g_nodes[1].node);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(NPQUEUE_SENTINEL_IS_EMPTY(&g_sentinel));
+}
+
+NTESTSUITE_TEST(test_nonempty_shift)
+{
+    /* Node 4 is alone at the highest level and stays at the head.
+     */
+    npqueue_sentinel_shift(&g_sentinel);
+    ntestsuite_expect_uint(4132u);
+    ntestsuite_actual_uint(trace());
+    npqueue_remove(&g_sentinel, &g_nodes[3].node);
+    npqueue_sentinel_shift(&g_sentinel);
+    ntestsuite_expect_uint(312u);
+    ntestsuite_actual_uint(trace());
+    insert(3u, 3u);
+    ntestsuite_expect_uint(3142u);
+    ntestsuite_actual_uint(trace());
+}
+
+static void setup_empty(void)
+{
+    npqueue_sentinel_init(&g_sentinel);
+}
+
+static void setup_nonempty(void)
+{
+    npqueue_sentinel_init(&g_sentinel);
+    insert(0u, 3u);
+    insert(1u, 1u);
+    insert(2u, 3u);
+    insert(3u, 7u);
+}
+
+void test_exec_npqueue(void)
+{
+    ntestsuite_set_fixture(empty, setup_empty, NULL);
+    ntestsuite_run(test_empty_is_empty);
+    ntestsuite_run(test_empty_insert_sort);
+    ntestsuite_run(test_empty_insert_group_boundary);
+
+    ntestsuite_set_fixture(nonempty, setup_nonempty, NULL);
+    ntestsuite_run(test_nonempty_remove_tail);
+    ntestsuite_run(test_nonempty_remove_level);
+    ntestsuite_run(test_nonempty_shift);
+}
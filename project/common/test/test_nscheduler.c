@@ -0,0 +1,1169 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../testsuite/ntestsuite.h"
+#include "neon.h"
+#include "test_nscheduler.h"
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1) || \
+    (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1) || \
+    (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+struct test_task
+{
+    struct nscheduler_task task;
+    uint32_t id;
+    bool stays_ready;
+};
+
+static struct nscheduler g_scheduler;
+static struct test_task g_tasks[3];
+static uint32_t g_trace;
+static uint32_t g_trace_count;
+static uint32_t g_trace_limit;
+
+static void trace(uint32_t id)
+{
+    g_trace = g_trace * 10u + id;
+
+    if (++g_trace_count == g_trace_limit) {
+        nscheduler_stop(&g_scheduler);
+    }
+}
+
+static void test_task_fn(struct nscheduler_task * task, void * arg)
+{
+    struct test_task * test_task = arg;
+    struct nos_critical local;
+
+    if (!test_task->stays_ready) {
+        nos_critical_lock(&local);
+        nscheduler_task_block(task);
+        nos_critical_unlock(&local);
+    }
+    trace(test_task->id);
+}
+
+static void test_task_init(uint32_t idx, uint8_t prio, bool stays_ready)
+{
+    struct nos_critical local;
+
+    g_tasks[idx].id = idx + 1u;
+    g_tasks[idx].stays_ready = stays_ready;
+    nscheduler_task_init(&g_scheduler, &g_tasks[idx].task, test_task_fn,
+            &g_tasks[idx], prio);
+    nos_critical_lock(&local);
+    nscheduler_task_ready(&g_tasks[idx].task);
+    nos_critical_unlock(&local);
+}
+
+static nsm_action epa_state_init(struct nsm * sm, const struct nevent * event);
+
+static struct test_epa_queue nevent_queue(4) g_test_epa_queue;
+
+static struct nepa g_test_epa = NEPA_INITIALIZER(
+        &g_test_epa_queue,
+        NEPA_FSM_TYPE,
+        epa_state_init,
+        NULL,
+        4);
+
+static nsm_action epa_state_init(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    trace(event->id);
+
+    if (event->id == NSM_INIT) {
+        nepa_send_signal(&g_test_epa, NSIGNAL_AFTER);
+    }
+    return nsm_event_handled();
+}
+
+#if (NCONFIG_EPA_EVENT_BUDGET > 1)
+static nsm_action budget_state(struct nsm * sm, const struct nevent * event);
+
+static struct budget_epa_queue nevent_queue(4) g_budget_epa_queue[2];
+
+static struct nepa g_budget_epa[2] =
+{
+    NEPA_INITIALIZER_BUDGET(
+            &g_budget_epa_queue[0],
+            NEPA_FSM_TYPE,
+            budget_state,
+            NULL,
+            2,
+            2),
+    NEPA_INITIALIZER_BUDGET(
+            &g_budget_epa_queue[1],
+            NEPA_FSM_TYPE,
+            budget_state,
+            NULL,
+            2,
+            1),
+};
+
+static nsm_action budget_state(struct nsm * sm, const struct nevent * event)
+{
+    struct nepa * epa = NPLATFORM_CONTAINER_OF(sm, struct nepa, sm);
+    uint32_t idx = (uint32_t)(epa - &g_budget_epa[0]);
+
+    trace(idx + 1u);
+
+    if (event->id == NSM_INIT) {
+        for (uint32_t i = 0u; i < (3u - idx); i++) {
+            nepa_send_signal(epa, NSIGNAL_EVERY);
+        }
+    }
+    return nsm_event_handled();
+}
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+enum preempt_mode
+{
+    PREEMPT_DIRECT,
+    PREEMPT_CEILING,
+    PREEMPT_ISR,
+    PREEMPT_ISR_STALLED
+};
+
+static enum preempt_mode g_preempt_mode;
+
+static nsm_action low_state(struct nsm * sm, const struct nevent * event);
+static nsm_action high_state(struct nsm * sm, const struct nevent * event);
+
+static struct low_epa_queue nevent_queue(4) g_low_epa_queue;
+static struct high_epa_queue nevent_queue(4) g_high_epa_queue;
+
+static struct nepa g_low_epa = NEPA_INITIALIZER(
+        &g_low_epa_queue,
+        NEPA_FSM_TYPE,
+        low_state,
+        NULL,
+        1);
+
+static struct nepa g_high_epa = NEPA_INITIALIZER(
+        &g_high_epa_queue,
+        NEPA_FSM_TYPE,
+        high_state,
+        NULL,
+        3);
+
+/* The low priority EPA traces 1 before and 2 after sending an event to the
+ * high priority EPA, which traces 3. In PREEMPT_ISR_STALLED mode the low
+ * priority EPA is preempted by the ISR in the middle of its own put to the
+ * high priority EPA.
+ */
+static nsm_action low_state(struct nsm * sm, const struct nevent * event)
+{
+    uint_fast8_t ceiling;
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+    uint32_t position;
+#endif
+    NPLATFORM_UNUSED_ARG(sm);
+
+    switch (event->id) {
+        case NSM_INIT:
+            nepa_send_signal(&g_low_epa, NSIGNAL_AFTER);
+            break;
+        case NSIGNAL_AFTER:
+            trace(1);
+
+            switch (g_preempt_mode) {
+                case PREEMPT_DIRECT:
+                    nepa_send_signal(&g_high_epa, NSIGNAL_AFTER);
+                    trace(2);
+                    break;
+                case PREEMPT_CEILING:
+                    ceiling = nscheduler_ceiling_raise(&g_scheduler, 3);
+                    nepa_send_signal(&g_high_epa, NSIGNAL_AFTER);
+                    trace(2);
+                    nscheduler_ceiling_restore(&g_scheduler, ceiling);
+                    break;
+                case PREEMPT_ISR:
+                    nscheduler_isr_enter(&g_scheduler);
+                    nepa_send_signal(&g_high_epa, NSIGNAL_AFTER);
+                    trace(2);
+                    nscheduler_isr_exit(&g_scheduler);
+                    break;
+                case PREEMPT_ISR_STALLED:
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+                    np_lqueue_mpsc_reserve(&g_high_epa.equeue.super,
+                            g_high_epa.equeue.np_lq_sequence, &position);
+                    nscheduler_isr_enter(&g_scheduler);
+                    nepa_send_signal(&g_high_epa, NSIGNAL_AFTER);
+                    trace(2);
+                    nscheduler_isr_exit(&g_scheduler);
+                    g_high_epa.equeue.np_lq_storage[
+                            position & g_high_epa.equeue.super.producer.mask] =
+                            nsm_signal(NSIGNAL_AFTER);
+                    nlqueue_mpsc_commit_put(&g_high_epa.equeue.super,
+                            g_high_epa.equeue.np_lq_sequence, position);
+                    narch_atomic_add_u32(&g_high_epa.pending, 1u);
+#endif
+                    break;
+            }
+            trace(4);
+            break;
+        default:
+            break;
+    }
+    return nsm_event_handled();
+}
+
+static nsm_action high_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    if (event->id == NSIGNAL_AFTER) {
+        trace(3);
+    }
+    return nsm_event_handled();
+}
+
+static struct nepa * const g_preempt_epas[] =
+{
+    &g_low_epa,
+    &g_high_epa,
+    NULL
+};
+#endif
+
+#if (NCONFIG_EPA_USE_PUBSUB == 1)
+static nsm_action publisher_state(struct nsm * sm, const struct nevent * event);
+static nsm_action subscriber_state(struct nsm * sm, const struct nevent * event);
+
+static struct publisher_epa_queue nevent_queue(4) g_publisher_epa_queue;
+static struct subscriber_epa_queue nevent_queue(4) g_subscriber_epa_queue[4];
+
+static struct nepa g_publisher_epa = NEPA_INITIALIZER(
+        &g_publisher_epa_queue,
+        NEPA_FSM_TYPE,
+        publisher_state,
+        NULL,
+        4);
+
+/* Subscriber at index i traces i + 1. Subscribers 0 - 2 have priority i + 1
+ * and subscriber 3 shares the priority with subscriber 0.
+ */
+static struct nepa g_subscriber_epa[4] =
+{
+    NEPA_INITIALIZER(&g_subscriber_epa_queue[0], NEPA_FSM_TYPE,
+            subscriber_state, NULL, 1),
+    NEPA_INITIALIZER(&g_subscriber_epa_queue[1], NEPA_FSM_TYPE,
+            subscriber_state, NULL, 2),
+    NEPA_INITIALIZER(&g_subscriber_epa_queue[2], NEPA_FSM_TYPE,
+            subscriber_state, NULL, 3),
+    NEPA_INITIALIZER(&g_subscriber_epa_queue[3], NEPA_FSM_TYPE,
+            subscriber_state, NULL, 1),
+};
+
+static struct nepa * const g_pubsub_epas[] =
+{
+    &g_publisher_epa,
+    &g_subscriber_epa[0],
+    &g_subscriber_epa[1],
+    &g_subscriber_epa[2],
+    NULL
+};
+
+static struct nepa * const g_same_priority_epas[] =
+{
+    &g_publisher_epa,
+    &g_subscriber_epa[0],
+    &g_subscriber_epa[3],
+    NULL
+};
+
+static nsm_action publisher_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    if (event->id == NSM_INIT) {
+        nepa_publish_signal(NSIGNAL_EVERY);
+    }
+    return nsm_event_handled();
+}
+
+static nsm_action subscriber_state(struct nsm * sm, const struct nevent * event)
+{
+    struct nepa * epa = NPLATFORM_CONTAINER_OF(sm, struct nepa, sm);
+
+    if (event->id == NSIGNAL_EVERY) {
+        trace((uint32_t)(epa - &g_subscriber_epa[0]) + 1u);
+    }
+    return nsm_event_handled();
+}
+#endif
+
+#if (NCONFIG_EPA_USE_DEFER == 1)
+#define DEFER_EVENT_DONE                (NEVENT_USER_ID + 3u)
+
+static nsm_action defer_state(struct nsm * sm, const struct nevent * event);
+
+static struct defer_epa_queue nevent_queue(4) g_defer_epa_queue;
+static struct defer_epa_dqueue nevent_queue(2) g_defer_epa_dqueue;
+static bool g_defer_is_busy;
+static bool g_defer_recall_all;
+
+/* Events are dispatched one by one so a recalled event is not overtaken by
+ * events claimed in the same activation.
+ */
+static struct nepa g_defer_epa = NEPA_INITIALIZER_BUDGET(
+        &g_defer_epa_queue,
+        NEPA_FSM_TYPE,
+        defer_state,
+        NULL,
+        3,
+        1);
+
+static const struct nevent g_defer_events[] =
+{
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 1u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 2u),
+    NEVENT_INITIALIZER(DEFER_EVENT_DONE),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 4u),
+};
+
+static nsm_action defer_state(struct nsm * sm, const struct nevent * event)
+{
+    struct nepa * epa = NPLATFORM_CONTAINER_OF(sm, struct nepa, sm);
+
+    if (event->id == NSM_INIT) {
+        g_defer_is_busy = true;
+
+        for (uint32_t i = 0u; i < NBITS_ARRAY_SIZE(g_defer_events); i++) {
+            nepa_send_event(epa, &g_defer_events[i]);
+        }
+    } else if (event->id >= NEVENT_USER_ID) {
+        if (g_defer_is_busy && (event->id != DEFER_EVENT_DONE)) {
+            nepa_defer(epa, event);
+        } else {
+            g_defer_is_busy = false;
+            trace(event->id - NEVENT_USER_ID);
+
+            while ((nepa_recall(epa) == EOK) && g_defer_recall_all) {
+                continue;
+            }
+        }
+    }
+    return nsm_event_handled();
+}
+#endif
+
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+static nsm_action urgent_state(struct nsm * sm, const struct nevent * event);
+
+static struct urgent_epa_queue nevent_queue(4) g_urgent_epa_queue;
+static struct urgent_epa_uqueue nevent_queue(2) g_urgent_epa_uqueue;
+
+static struct nepa g_urgent_epa = NEPA_INITIALIZER_BUDGET(
+        &g_urgent_epa_queue,
+        NEPA_FSM_TYPE,
+        urgent_state,
+        NULL,
+        3,
+        4);
+
+static const struct nevent g_urgent_events[] =
+{
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 1u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 2u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 3u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 4u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 5u),
+};
+
+static nsm_action urgent_state(struct nsm * sm, const struct nevent * event)
+{
+    struct nepa * epa = NPLATFORM_CONTAINER_OF(sm, struct nepa, sm);
+
+    if (event->id == NSM_INIT) {
+        nepa_send_event(epa, &g_urgent_events[0]);
+        nepa_send_event(epa, &g_urgent_events[1]);
+        nepa_send_event(epa, &g_urgent_events[2]);
+        nepa_send_event_urgent(epa, &g_urgent_events[3]);
+        nepa_send_event_urgent(epa, &g_urgent_events[4]);
+        /* The urgent lane is full.
+         */
+        nepa_send_event_urgent(epa, &g_urgent_events[4]);
+    } else if (event->id >= NEVENT_USER_ID) {
+        trace(event->id - NEVENT_USER_ID);
+    }
+    return nsm_event_handled();
+}
+#endif
+
+#if (NCONFIG_EPA_USE_ARENA == 1)
+static nsm_action arena_state(struct nsm * sm, const struct nevent * event);
+
+static struct arena_epa_queue nevent_queue(4) g_arena_epa_queue;
+static struct arena_epa_arena narena(64) g_arena_epa_arena;
+static void * g_arena_scratch;
+
+static struct nepa g_arena_epa = NEPA_INITIALIZER_BUDGET(
+        &g_arena_epa_queue,
+        NEPA_FSM_TYPE,
+        arena_state,
+        NULL,
+        3,
+        4);
+
+static const struct nevent g_arena_events[] =
+{
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 1u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 2u),
+    NEVENT_INITIALIZER(NEVENT_USER_ID + 3u),
+};
+
+/* Each event allocates scratch memory, which is released after the event is
+ * dispatched, so every allocation gets the same memory. A leaked allocation
+ * is traced as 9.
+ */
+static nsm_action arena_state(struct nsm * sm, const struct nevent * event)
+{
+    struct nepa * epa = NPLATFORM_CONTAINER_OF(sm, struct nepa, sm);
+    void * scratch = narena_alloc(epa->arena, 48u);
+
+    if (event->id == NSM_INIT) {
+        g_arena_scratch = scratch;
+        nepa_send_event(epa, &g_arena_events[0]);
+        nepa_send_event(epa, &g_arena_events[1]);
+        nepa_send_event(epa, &g_arena_events[2]);
+    } else if (event->id >= NEVENT_USER_ID) {
+        if (scratch == g_arena_scratch) {
+            trace(event->id - NEVENT_USER_ID);
+        } else {
+            trace(9u);
+        }
+    }
+    return nsm_event_handled();
+}
+#endif
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+#define MPSC_PRODUCERS                  4u
+#define MPSC_EVENTS                     1000u
+
+static uint32_t g_mpsc_events;
+
+static nsm_action hub_state(struct nsm * sm, const struct nevent * event);
+
+static struct hub_epa_queue nevent_queue(8) g_hub_epa_queue;
+
+static struct nepa g_hub_epa = NEPA_INITIALIZER(
+        &g_hub_epa_queue,
+        NEPA_FSM_TYPE,
+        hub_state,
+        NULL,
+        2);
+
+static nsm_action hub_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    if (event->id == NSIGNAL_EVERY) {
+        if (++g_mpsc_events == (MPSC_PRODUCERS * MPSC_EVENTS)) {
+            nscheduler_stop(&g_scheduler);
+        }
+    }
+    return nsm_event_handled();
+}
+
+static void * mpsc_producer_thread(void * arg)
+{
+    NPLATFORM_UNUSED_ARG(arg);
+
+    while (!nscheduler_is_started(&g_scheduler)) {
+        sched_yield();
+    }
+
+    for (uint32_t i = 0u; i < MPSC_EVENTS; i++) {
+        while (nepa_send_signal(&g_hub_epa, NSIGNAL_EVERY) != EOK) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+#endif
+
+static struct nepa * const g_no_epas[] =
+{
+    NULL
+};
+
+static struct nepa * const g_test_epas[] =
+{
+    &g_test_epa,
+    NULL
+};
+
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+#define PING_PONG_ROUNDS                100u
+
+static struct nscheduler g_remote_scheduler;
+static uint32_t g_ping_pong_rounds;
+
+static nsm_action ping_state(struct nsm * sm, const struct nevent * event);
+static nsm_action pong_state(struct nsm * sm, const struct nevent * event);
+
+static struct ping_epa_queue nevent_queue(4) g_ping_epa_queue;
+static struct pong_epa_queue nevent_queue(4) g_pong_epa_queue;
+
+static struct nepa g_ping_epa = NEPA_INITIALIZER(
+        &g_ping_epa_queue,
+        NEPA_FSM_TYPE,
+        ping_state,
+        NULL,
+        2);
+
+static struct nepa g_pong_epa = NEPA_INITIALIZER(
+        &g_pong_epa_queue,
+        NEPA_FSM_TYPE,
+        pong_state,
+        NULL,
+        2);
+
+static nsm_action ping_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    switch (event->id) {
+        case NSIGNAL_EVERY:
+            if (++g_ping_pong_rounds == PING_PONG_ROUNDS) {
+                nscheduler_stop(&g_remote_scheduler);
+                nscheduler_stop(&g_scheduler);
+                break;
+            }
+            /* fall through */
+        case NSM_INIT:
+            nepa_send_signal(&g_pong_epa, NSIGNAL_AFTER);
+            break;
+        default:
+            break;
+    }
+    return nsm_event_handled();
+}
+
+static nsm_action pong_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    if (event->id == NSIGNAL_AFTER) {
+        nepa_send_signal(&g_ping_epa, NSIGNAL_EVERY);
+    }
+    return nsm_event_handled();
+}
+
+static void * remote_thread(void * arg)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_pong_epa,
+        NULL
+    };
+    NPLATFORM_UNUSED_ARG(arg);
+
+    nscheduler_start(&g_remote_scheduler, epas);
+
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_none_cross_core_post)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_ping_epa,
+        NULL
+    };
+    pthread_t thread;
+
+    nscheduler_init(&g_remote_scheduler);
+    pthread_create(&thread, NULL, remote_thread, NULL);
+
+    while (!nscheduler_is_started(&g_remote_scheduler)) {
+        ;
+    }
+    nscheduler_start(&g_scheduler, epas);
+    pthread_join(thread, NULL);
+
+    ntestsuite_expect_uint(PING_PONG_ROUNDS);
+    ntestsuite_actual_uint(g_ping_pong_rounds);
+}
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+#define POOL_EPAS                       6u
+#define POOL_EVENTS                     1000u
+
+struct pool_epa
+{
+    struct nepa epa;
+    uint32_t is_busy;
+    uint32_t events;
+};
+
+static struct nscheduler_pool g_pool;
+static uint32_t g_pool_events;
+static uint32_t g_pool_overlaps;
+
+static nsm_action pool_state(struct nsm * sm, const struct nevent * event);
+
+static struct pool_epa_queue nevent_queue(4) g_pool_epa_queue[POOL_EPAS];
+
+#define POOL_EPA_INITIALIZER(a_idx)                                         \
+    {                                                                       \
+        .epa = NEPA_INITIALIZER(                                            \
+                &g_pool_epa_queue[a_idx],                                   \
+                NEPA_FSM_TYPE,                                              \
+                pool_state,                                                 \
+                NULL,                                                       \
+                2)                                                          \
+    }
+
+static struct pool_epa g_pool_epa[POOL_EPAS] =
+{
+    POOL_EPA_INITIALIZER(0),
+    POOL_EPA_INITIALIZER(1),
+    POOL_EPA_INITIALIZER(2),
+    POOL_EPA_INITIALIZER(3),
+    POOL_EPA_INITIALIZER(4),
+    POOL_EPA_INITIALIZER(5),
+};
+
+static nsm_action pool_state(struct nsm * sm, const struct nevent * event)
+{
+    struct pool_epa * pool_epa = NPLATFORM_CONTAINER_OF(sm, struct pool_epa,
+            epa.sm);
+    NPLATFORM_UNUSED_ARG(event);
+
+    /* Check that the same EPA is never dispatched by two workers at once.
+     */
+    if (__atomic_exchange_n(&pool_epa->is_busy, 1u, __ATOMIC_ACQUIRE)) {
+        __atomic_add_fetch(&g_pool_overlaps, 1u, __ATOMIC_RELAXED);
+    }
+    pool_epa->events++;
+    __atomic_store_n(&pool_epa->is_busy, 0u, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&g_pool_events, 1u, __ATOMIC_RELEASE);
+
+    return nsm_event_handled();
+}
+
+static void * pool_worker_thread(void * arg)
+{
+    nscheduler_pool_worker(&g_pool, (uint_fast8_t)(uintptr_t)arg);
+
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_none_pool_register_errors)
+{
+    static struct nepa * epas[NCONFIG_SCHEDULER_POOL_QUEUE_SIZE + 2u];
+
+    for (uint32_t i = 0u; i <= NCONFIG_SCHEDULER_POOL_QUEUE_SIZE; i++) {
+        epas[i] = &g_pool_epa[0].epa;
+    }
+    epas[NCONFIG_SCHEDULER_POOL_QUEUE_SIZE + 1u] = NULL;
+    nscheduler_pool_init(&g_pool);
+
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nscheduler_pool_register(&g_pool, epas));
+    ntestsuite_expect_ptr(NULL);
+    ntestsuite_actual_ptr(g_pool_epa[0].epa.pool.pool);
+}
+
+NTESTSUITE_TEST(test_none_pool_dispatch)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_pool_epa[0].epa,
+        &g_pool_epa[1].epa,
+        &g_pool_epa[2].epa,
+        &g_pool_epa[3].epa,
+        &g_pool_epa[4].epa,
+        &g_pool_epa[5].epa,
+        NULL
+    };
+    pthread_t threads[NCONFIG_SCHEDULER_POOL_WORKERS];
+    uint32_t events = 0u;
+
+    nscheduler_pool_init(&g_pool);
+
+    for (uintptr_t i = 0u; i < NCONFIG_SCHEDULER_POOL_WORKERS; i++) {
+        pthread_create(&threads[i], NULL, pool_worker_thread, (void *)i);
+    }
+    nscheduler_pool_register(&g_pool, epas);
+
+    for (uint32_t i = 0u; i < POOL_EVENTS; i++) {
+        for (uint32_t epa = 0u; epa < POOL_EPAS; epa++) {
+            while (nepa_send_signal(&g_pool_epa[epa].epa, NSIGNAL_AFTER)) {
+                sched_yield();
+            }
+        }
+    }
+
+    while (__atomic_load_n(&g_pool_events, __ATOMIC_ACQUIRE) !=
+            (POOL_EVENTS + 1u) * POOL_EPAS) {
+        sched_yield();
+    }
+    nscheduler_pool_stop(&g_pool);
+
+    for (uint32_t i = 0u; i < NCONFIG_SCHEDULER_POOL_WORKERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (uint32_t epa = 0u; epa < POOL_EPAS; epa++) {
+        events += g_pool_epa[epa].events;
+    }
+    ntestsuite_expect_uint((POOL_EVENTS + 1u) * POOL_EPAS);
+    ntestsuite_actual_uint(events);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(g_pool_overlaps);
+}
+
+NTESTSUITE_TEST(test_none_pool_register_total)
+{
+    static struct nepa * epas[NCONFIG_SCHEDULER_POOL_QUEUE_SIZE];
+    uint32_t count = NCONFIG_SCHEDULER_POOL_QUEUE_SIZE - POOL_EPAS + 1u;
+
+    /* The pool already holds POOL_EPAS EPAs, the registry alone would fit.
+     */
+    for (uint32_t i = 0u; i < count; i++) {
+        epas[i] = &g_pool_epa[0].epa;
+    }
+    epas[count] = NULL;
+
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nscheduler_pool_register(&g_pool, epas));
+}
+#endif
+
+NTESTSUITE_TEST(test_none_is_started)
+{
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(nscheduler_is_started(&g_scheduler));
+}
+
+NTESTSUITE_TEST(test_none_priority_order)
+{
+    test_task_init(0, 1, false);
+    test_task_init(1, 3, false);
+    test_task_init(2, 2, false);
+    g_trace_limit = 3u;
+    nscheduler_start(&g_scheduler, g_no_epas);
+
+    ntestsuite_expect_uint(231);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_round_robin)
+{
+    test_task_init(0, 2, true);
+    test_task_init(1, 2, true);
+    test_task_init(2, 1, true);
+    g_trace_limit = 4u;
+    nscheduler_start(&g_scheduler, g_no_epas);
+
+    ntestsuite_expect_uint(1212);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_ready_twice)
+{
+    struct nos_critical local;
+
+    test_task_init(0, 2, false);
+    test_task_init(1, 2, false);
+    nos_critical_lock(&local);
+    nscheduler_task_ready(&g_tasks[0].task);
+    nscheduler_task_ready(&g_tasks[1].task);
+    nos_critical_unlock(&local);
+    g_trace_limit = 2u;
+    nscheduler_start(&g_scheduler, g_no_epas);
+
+    ntestsuite_expect_uint(12);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_block_ready)
+{
+    struct nos_critical local;
+
+    test_task_init(0, 2, false);
+    test_task_init(1, 2, false);
+    nos_critical_lock(&local);
+    nscheduler_task_block(&g_tasks[0].task);
+    nos_critical_unlock(&local);
+    g_trace_limit = 1u;
+    nscheduler_start(&g_scheduler, g_no_epas);
+
+    ntestsuite_expect_uint(2);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_epa_dispatch)
+{
+    g_trace_limit = 2u;
+    nscheduler_start(&g_scheduler, g_test_epas);
+
+    ntestsuite_expect_uint(NSM_INIT * 10u + NSIGNAL_AFTER);
+    ntestsuite_actual_uint(g_trace);
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(nscheduler_is_started(&g_scheduler));
+}
+
+#if (NCONFIG_EPA_EVENT_BUDGET > 1)
+NTESTSUITE_TEST(test_none_epa_budget)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_budget_epa[0],
+        &g_budget_epa[1],
+        NULL
+    };
+    /* The first EPA dispatches up to 2 events per activation, the second one
+     * only 1 event per activation.
+     */
+    g_trace_limit = 7u;
+    nscheduler_start(&g_scheduler, epas);
+
+    ntestsuite_expect_uint(1211212);
+    ntestsuite_actual_uint(g_trace);
+}
+#endif
+
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+NTESTSUITE_TEST(test_none_preempt_direct)
+{
+    g_preempt_mode = PREEMPT_DIRECT;
+    g_trace_limit = 4u;
+    nscheduler_start(&g_scheduler, g_preempt_epas);
+
+    ntestsuite_expect_uint(1324);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_preempt_ceiling)
+{
+    g_preempt_mode = PREEMPT_CEILING;
+    g_trace_limit = 4u;
+    nscheduler_start(&g_scheduler, g_preempt_epas);
+
+    ntestsuite_expect_uint(1234);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_preempt_isr)
+{
+    g_preempt_mode = PREEMPT_ISR;
+    g_trace_limit = 4u;
+    nscheduler_start(&g_scheduler, g_preempt_epas);
+
+    ntestsuite_expect_uint(1234);
+    ntestsuite_actual_uint(g_trace);
+}
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+/* The high priority EPA is ready, but its oldest event is not put yet. The
+ * preemption returns to the low priority EPA, which finishes the put, and
+ * the high priority EPA gets both events after it.
+ */
+NTESTSUITE_TEST(test_none_preempt_isr_stalled)
+{
+    g_preempt_mode = PREEMPT_ISR_STALLED;
+    g_trace_limit = 5u;
+    nscheduler_start(&g_scheduler, g_preempt_epas);
+
+    ntestsuite_expect_uint(12433);
+    ntestsuite_actual_uint(g_trace);
+}
+#endif
+#endif
+
+#if (NCONFIG_EPA_USE_PUBSUB == 1)
+NTESTSUITE_TEST(test_none_publish)
+{
+    for (uint32_t i = 0u; i < 3u; i++) {
+        nepa_subscribe(&g_subscriber_epa[i], NSIGNAL_EVERY);
+    }
+    g_trace_limit = 3u;
+    nscheduler_start(&g_scheduler, g_pubsub_epas);
+
+    for (uint32_t i = 0u; i < 3u; i++) {
+        nepa_unsubscribe(&g_subscriber_epa[i], NSIGNAL_EVERY);
+    }
+    ntestsuite_expect_uint(321);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_publish_unsubscribed)
+{
+    nepa_subscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_subscribe(&g_subscriber_epa[2], NSIGNAL_EVERY);
+    g_trace_limit = 2u;
+    nscheduler_start(&g_scheduler, g_pubsub_epas);
+
+    nepa_unsubscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_unsubscribe(&g_subscriber_epa[2], NSIGNAL_EVERY);
+    ntestsuite_expect_uint(31);
+    ntestsuite_actual_uint(g_trace);
+}
+
+/* Subscriber 0 subscribes to two signals, so it stays subscribed to the
+ * remaining one.
+ */
+NTESTSUITE_TEST(test_none_publish_same_priority)
+{
+    nepa_subscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_subscribe(&g_subscriber_epa[3], NSIGNAL_EVERY);
+    nepa_subscribe(&g_subscriber_epa[0], NSIGNAL_AFTER);
+    nepa_unsubscribe(&g_subscriber_epa[0], NSIGNAL_AFTER);
+    g_trace_limit = 2u;
+    nscheduler_start(&g_scheduler, g_same_priority_epas);
+
+    nepa_unsubscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_unsubscribe(&g_subscriber_epa[3], NSIGNAL_EVERY);
+    ntestsuite_expect_uint(14);
+    ntestsuite_actual_uint(g_trace);
+}
+
+/* An EPA which has unsubscribed from all signals is unlinked, so it is linked
+ * again only once when it subscribes again.
+ */
+NTESTSUITE_TEST(test_none_publish_resubscribe)
+{
+    nepa_subscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_unsubscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_subscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_subscribe(&g_subscriber_epa[3], NSIGNAL_EVERY);
+    g_trace_limit = 2u;
+    nscheduler_start(&g_scheduler, g_same_priority_epas);
+
+    nepa_unsubscribe(&g_subscriber_epa[0], NSIGNAL_EVERY);
+    nepa_unsubscribe(&g_subscriber_epa[3], NSIGNAL_EVERY);
+    ntestsuite_expect_uint(14);
+    ntestsuite_actual_uint(g_trace);
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(g_subscriber_epa[0].is_subscriber);
+}
+
+NTESTSUITE_TEST(test_none_subscribe_errors)
+{
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nepa_subscribe(&g_subscriber_epa[0],
+            NCONFIG_EPA_PUBSUB_SIGNALS));
+    ntestsuite_expect_int(-EARG_OUTOFRANGE);
+    ntestsuite_actual_int(nepa_unsubscribe(&g_subscriber_epa[0],
+            NCONFIG_EPA_PUBSUB_SIGNALS));
+    /* Test EPA has the same priority as the publisher EPA.
+     */
+    ntestsuite_expect_int(EOK);
+    ntestsuite_actual_int(nepa_subscribe(&g_publisher_epa, NSIGNAL_AFTER));
+    ntestsuite_expect_int(EOK);
+    ntestsuite_actual_int(nepa_subscribe(&g_test_epa, NSIGNAL_AFTER));
+    nepa_unsubscribe(&g_publisher_epa, NSIGNAL_AFTER);
+    nepa_unsubscribe(&g_test_epa, NSIGNAL_AFTER);
+}
+#endif
+
+#if (NCONFIG_EPA_USE_DEFER == 1)
+NTESTSUITE_TEST(test_none_defer_recall)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_defer_epa,
+        NULL
+    };
+    /* Events 1 and 2 are deferred until event 3 is received. Recalled events
+     * are dispatched before event 4 which waits in the queue.
+     */
+    NEPA_DEFER_INIT(&g_defer_epa, &g_defer_epa_dqueue);
+    g_defer_recall_all = false;
+    g_trace_limit = 4u;
+    nscheduler_start(&g_scheduler, epas);
+
+    ntestsuite_expect_uint(3124);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_defer_recall_all)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_defer_epa,
+        NULL
+    };
+    /* Both deferred events are recalled at once, they keep the order they
+     * were deferred in.
+     */
+    NEPA_DEFER_INIT(&g_defer_epa, &g_defer_epa_dqueue);
+    g_defer_recall_all = true;
+    g_trace_limit = 4u;
+    nscheduler_start(&g_scheduler, epas);
+
+    ntestsuite_expect_uint(3124);
+    ntestsuite_actual_uint(g_trace);
+}
+
+NTESTSUITE_TEST(test_none_defer_errors)
+{
+    ntestsuite_expect_int(-EOBJ_INVALID);
+    ntestsuite_actual_int(nepa_defer(&g_test_epa, &g_defer_events[0]));
+    ntestsuite_expect_int(-EOBJ_INVALID);
+    ntestsuite_actual_int(nepa_recall(&g_test_epa));
+    NEPA_DEFER_INIT(&g_defer_epa, &g_defer_epa_dqueue);
+    ntestsuite_expect_int(-EOBJ_INVALID);
+    ntestsuite_actual_int(nepa_recall(&g_defer_epa));
+    ntestsuite_expect_int(EOK);
+    ntestsuite_actual_int(nepa_defer(&g_defer_epa, &g_defer_events[0]));
+    ntestsuite_expect_int(EOK);
+    ntestsuite_actual_int(nepa_defer(&g_defer_epa, &g_defer_events[1]));
+    ntestsuite_expect_int(-EOBJ_INVALID);
+    ntestsuite_actual_int(nepa_defer(&g_defer_epa, &g_defer_events[2]));
+}
+#endif
+
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+NTESTSUITE_TEST(test_none_urgent_lane)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_urgent_epa,
+        NULL
+    };
+    /* Urgent events 4 and 5 overtake events 1, 2 and 3 which wait in the
+     * event queue.
+     */
+    NEPA_URGENT_INIT(&g_urgent_epa, &g_urgent_epa_uqueue);
+    g_trace_limit = 5u;
+    nscheduler_start(&g_scheduler, epas);
+
+    ntestsuite_expect_uint(45123);
+    ntestsuite_actual_uint(g_trace);
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_urgent_epa.uoverflows);
+}
+
+NTESTSUITE_TEST(test_none_urgent_errors)
+{
+    ntestsuite_expect_int(-EOBJ_INVALID);
+    ntestsuite_actual_int(nepa_send_event_urgent(&g_test_epa,
+            &g_urgent_events[0]));
+}
+#endif
+
+#if (NCONFIG_EPA_USE_ARENA == 1)
+NTESTSUITE_TEST(test_none_arena_reset)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_arena_epa,
+        NULL
+    };
+    NARENA_INIT(&g_arena_epa_arena);
+    NEPA_ARENA_INIT(&g_arena_epa, &g_arena_epa_arena);
+    g_trace_limit = 3u;
+    nscheduler_start(&g_scheduler, epas);
+
+    ntestsuite_expect_uint(123);
+    ntestsuite_actual_uint(g_trace);
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(NARENA_USED(&g_arena_epa_arena));
+}
+#endif
+
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+NTESTSUITE_TEST(test_none_mpsc_producers)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_hub_epa,
+        NULL
+    };
+    pthread_t threads[MPSC_PRODUCERS];
+
+    g_mpsc_events = 0u;
+
+    for (uint32_t i = 0u; i < MPSC_PRODUCERS; i++) {
+        pthread_create(&threads[i], NULL, mpsc_producer_thread, NULL);
+    }
+    nscheduler_start(&g_scheduler, epas);
+
+    for (uint32_t i = 0u; i < MPSC_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    ntestsuite_expect_uint(MPSC_PRODUCERS * MPSC_EVENTS);
+    ntestsuite_actual_uint(g_mpsc_events);
+}
+#endif
+
+static void setup_none(void)
+{
+    nscheduler_init(&g_scheduler);
+    g_trace = 0u;
+    g_trace_count = 0u;
+    g_trace_limit = 0u;
+}
+
+void test_exec_nscheduler(void)
+{
+    ntestsuite_set_fixture(none, setup_none, NULL);
+    ntestsuite_run(test_none_is_started);
+    ntestsuite_run(test_none_priority_order);
+    ntestsuite_run(test_none_round_robin);
+    ntestsuite_run(test_none_ready_twice);
+    ntestsuite_run(test_none_block_ready);
+    ntestsuite_run(test_none_epa_dispatch);
+#if (NCONFIG_EPA_EVENT_BUDGET > 1)
+    ntestsuite_run(test_none_epa_budget);
+#endif
+#if (NCONFIG_SCHEDULER_USE_MULTICORE == 1)
+    ntestsuite_run(test_none_cross_core_post);
+#endif
+#if (NCONFIG_SCHEDULER_USE_WORK_STEALING == 1)
+    ntestsuite_run(test_none_pool_register_errors);
+    ntestsuite_run(test_none_pool_dispatch);
+    ntestsuite_run(test_none_pool_register_total);
+#endif
+#if (NCONFIG_EPA_USE_PUBSUB == 1)
+    ntestsuite_run(test_none_publish);
+    ntestsuite_run(test_none_publish_unsubscribed);
+    ntestsuite_run(test_none_publish_same_priority);
+    ntestsuite_run(test_none_publish_resubscribe);
+    ntestsuite_run(test_none_subscribe_errors);
+#endif
+#if (NCONFIG_EPA_USE_DEFER == 1)
+    ntestsuite_run(test_none_defer_recall);
+    ntestsuite_run(test_none_defer_recall_all);
+    ntestsuite_run(test_none_defer_errors);
+#endif
+#if (NCONFIG_EPA_USE_URGENT_LANE == 1)
+    ntestsuite_run(test_none_urgent_lane);
+    ntestsuite_run(test_none_urgent_errors);
+#endif
+#if (NCONFIG_EPA_USE_ARENA == 1)
+    ntestsuite_run(test_none_arena_reset);
+#endif
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+    ntestsuite_run(test_none_mpsc_producers);
+#endif
+#if (NCONFIG_SCHEDULER_USE_PREEMPTION == 1)
+    ntestsuite_run(test_none_preempt_direct);
+    ntestsuite_run(test_none_preempt_ceiling);
+    ntestsuite_run(test_none_preempt_isr);
+#if (NCONFIG_EPA_USE_MPSC_QUEUE == 1)
+    ntestsuite_run(test_none_preempt_isr_stalled);
+#endif
+#endif
+}
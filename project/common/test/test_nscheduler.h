@@ -0,0 +1,21 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#ifndef TEST_NSCHEDULER_H_
+#define TEST_NSCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void test_exec_nscheduler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_NSCHEDULER_H_ */
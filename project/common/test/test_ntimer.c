@@ -0,0 +1,476 @@
+/*
+ * Neon
+ * Copyright (C) 2018   REAL-TIME CONSULTING
+ *
+ * For license information refer to LGPL-3.0.md file at the root of this project.
+ */
+
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1)
+#define _POSIX_C_SOURCE                 200809L
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../testsuite/ntestsuite.h"
+#include "neon.h"
+#include "test_ntimer.h"
+
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1)
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#define MANY_TIMERS                     200u
+
+static struct nscheduler g_scheduler;
+static struct ntimer_wheel g_wheel;
+static struct ntimer g_timers[MANY_TIMERS];
+static void (* g_arm)(void);
+static uint32_t g_ticks;
+static uint32_t g_tick_limit;
+static uint32_t g_fired[8];
+static uint32_t g_fired_count;
+static uint32_t g_fired_sum;
+
+static nsm_action ticker_state(struct nsm * sm, const struct nevent * event);
+
+static struct ticker_epa_queue nevent_queue(8) g_ticker_epa_queue;
+
+static struct nepa g_ticker_epa = NEPA_INITIALIZER(
+        &g_ticker_epa_queue,
+        NEPA_FSM_TYPE,
+        ticker_state,
+        NULL,
+        2);
+
+static struct nepa * const g_epas[] =
+{
+    &g_ticker_epa,
+    NULL
+};
+
+/* The EPA advances the timing wheel by one tick on each NSIGNAL_RETRIGGER
+ * and records the tick at which a timer signal is received.
+ */
+static nsm_action ticker_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    switch (event->id) {
+        case NSM_INIT:
+            g_arm();
+            nepa_send_signal(&g_ticker_epa, NSIGNAL_RETRIGGER);
+            break;
+        case NSIGNAL_RETRIGGER:
+            if (g_ticks == g_tick_limit) {
+                nscheduler_stop(&g_scheduler);
+                break;
+            }
+            g_ticks++;
+            ntimer_wheel_tick(&g_wheel);
+            nepa_send_signal(&g_ticker_epa, NSIGNAL_RETRIGGER);
+            break;
+        case NSIGNAL_AFTER:
+        case NSIGNAL_EVERY:
+            if (g_fired_count < NBITS_ARRAY_SIZE(g_fired)) {
+                g_fired[g_fired_count] = g_ticks;
+            }
+            g_fired_count++;
+            g_fired_sum += g_ticks;
+            break;
+        default:
+            break;
+    }
+    return nsm_event_handled();
+}
+
+static void arm_after(void)
+{
+    ntimer_after(&g_wheel, &g_timers[0], 3u);
+}
+
+static void arm_every(void)
+{
+    ntimer_every(&g_wheel, &g_timers[0], 2u);
+}
+
+static void arm_cancel(void)
+{
+    ntimer_after(&g_wheel, &g_timers[0], 3u);
+    ntimer_every(&g_wheel, &g_timers[1], 2u);
+    ntimer_cancel(&g_timers[0]);
+    ntimer_cancel(&g_timers[1]);
+}
+
+static void arm_rearm(void)
+{
+    ntimer_after(&g_wheel, &g_timers[0], 3u);
+    ntimer_after(&g_wheel, &g_timers[0], 5u);
+}
+
+static void arm_cascade(void)
+{
+    ntimer_after(&g_wheel, &g_timers[0], 70u);
+    ntimer_after(&g_wheel, &g_timers[1], 4096u);
+    ntimer_after(&g_wheel, &g_timers[2], 5000u);
+}
+
+static void arm_advance(void)
+{
+    ntimer_after(&g_wheel, &g_timers[0], 70u);
+    ntimer_every(&g_wheel, &g_timers[1], 30u);
+    ntimer_wheel_advance(&g_wheel, 100u);
+}
+
+static void arm_many(void)
+{
+    for (uint32_t i = 0u; i < MANY_TIMERS; i++) {
+        ntimer_after(&g_wheel, &g_timers[i], i * 37u + 1u);
+    }
+}
+
+NTESTSUITE_TEST(test_none_after)
+{
+    g_arm = arm_after;
+    g_tick_limit = 10u;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_uint(3u);
+    ntestsuite_actual_uint(g_fired[0]);
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(ntimer_is_running(&g_timers[0]));
+}
+
+NTESTSUITE_TEST(test_none_every)
+{
+    g_arm = arm_every;
+    g_tick_limit = 7u;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    ntestsuite_expect_uint(3u);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_uint(2u);
+    ntestsuite_actual_uint(g_fired[0]);
+    ntestsuite_expect_uint(4u);
+    ntestsuite_actual_uint(g_fired[1]);
+    ntestsuite_expect_uint(6u);
+    ntestsuite_actual_uint(g_fired[2]);
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(ntimer_is_running(&g_timers[0]));
+}
+
+NTESTSUITE_TEST(test_none_cancel)
+{
+    g_arm = arm_cancel;
+    g_tick_limit = 10u;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    ntestsuite_expect_uint(0u);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(ntimer_is_running(&g_timers[1]));
+}
+
+NTESTSUITE_TEST(test_none_rearm)
+{
+    g_arm = arm_rearm;
+    g_tick_limit = 10u;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    ntestsuite_expect_uint(1u);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_uint(5u);
+    ntestsuite_actual_uint(g_fired[0]);
+}
+
+NTESTSUITE_TEST(test_none_cascade)
+{
+    g_arm = arm_cascade;
+    g_tick_limit = 5000u;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    ntestsuite_expect_uint(3u);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_uint(70u);
+    ntestsuite_actual_uint(g_fired[0]);
+    ntestsuite_expect_uint(4096u);
+    ntestsuite_actual_uint(g_fired[1]);
+    ntestsuite_expect_uint(5000u);
+    ntestsuite_actual_uint(g_fired[2]);
+}
+
+NTESTSUITE_TEST(test_none_many)
+{
+    g_arm = arm_many;
+    g_tick_limit = MANY_TIMERS * 37u;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    /* Sum of (i * 37 + 1) for i in 0 .. MANY_TIMERS - 1.
+     */
+    ntestsuite_expect_uint(MANY_TIMERS);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_uint(37u * (MANY_TIMERS * (MANY_TIMERS - 1u) / 2u) +
+            MANY_TIMERS);
+    ntestsuite_actual_uint(g_fired_sum);
+}
+
+NTESTSUITE_TEST(test_none_next)
+{
+    ntestsuite_expect_uint(NTIMER_INFINITE);
+    ntestsuite_actual_uint(ntimer_wheel_next(&g_wheel));
+    ntimer_after(&g_wheel, &g_timers[0], 70u);
+    /* Level 1 slot is cascaded after 64 ticks.
+     */
+    ntestsuite_expect_uint(64u);
+    ntestsuite_actual_uint(ntimer_wheel_next(&g_wheel));
+    ntimer_after(&g_wheel, &g_timers[1], 5u);
+    ntestsuite_expect_uint(5u);
+    ntestsuite_actual_uint(ntimer_wheel_next(&g_wheel));
+}
+
+NTESTSUITE_TEST(test_none_advance)
+{
+    g_arm = arm_advance;
+    nscheduler_start(&g_scheduler, g_epas);
+
+    /* Periodic timer expires at 30, 60 and 90, one-shot timer at 70.
+     */
+    ntestsuite_expect_uint(4u);
+    ntestsuite_actual_uint(g_fired_count);
+    ntestsuite_expect_uint(100u);
+    ntestsuite_actual_uint(g_wheel.now);
+    ntestsuite_expect_uint(20u);
+    ntestsuite_actual_uint(ntimer_wheel_next(&g_wheel));
+}
+
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1)
+#define SLEEP_TICKS                     20u
+
+static struct ntimer g_sleeper_timer;
+static uint32_t g_sleeper_ticks;
+
+static nsm_action sleeper_state(struct nsm * sm, const struct nevent * event);
+
+static struct sleeper_epa_queue nevent_queue(4) g_sleeper_epa_queue;
+
+static struct nepa g_sleeper_epa = NEPA_INITIALIZER(
+        &g_sleeper_epa_queue,
+        NEPA_FSM_TYPE,
+        sleeper_state,
+        NULL,
+        2);
+
+static struct nepa * const g_sleeper_epas[] =
+{
+    &g_sleeper_epa,
+    NULL
+};
+
+static nsm_action sleeper_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    switch (event->id) {
+        case NSM_INIT:
+            g_sleeper_ticks = nos_tick_count();
+            ntimer_init(&g_sleeper_timer, &g_sleeper_epa);
+            ntimer_after(&nsys_timer_wheel, &g_sleeper_timer, SLEEP_TICKS);
+            break;
+        case NSIGNAL_AFTER:
+            g_sleeper_ticks = nos_tick_count() - g_sleeper_ticks;
+            nscheduler_stop(&g_scheduler);
+            break;
+        case NSIGNAL_EVERY:
+            nscheduler_stop(&g_scheduler);
+            break;
+        default:
+            break;
+    }
+    return nsm_event_handled();
+}
+
+static uint64_t cpu_time_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+    return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+static void * sender_thread(void * arg)
+{
+    struct timespec delay = {
+        .tv_nsec = 10000000
+    };
+    NPLATFORM_UNUSED_ARG(arg);
+
+    nanosleep(&delay, NULL);
+    nepa_send_signal(&g_sleeper_epa, NSIGNAL_EVERY);
+
+    return NULL;
+}
+
+/* The busy EPA is always ready, so the idle EPA never runs.
+ */
+static nsm_action busy_state(struct nsm * sm, const struct nevent * event)
+{
+    struct nepa * epa = NPLATFORM_CONTAINER_OF(sm, struct nepa, sm);
+
+    switch (event->id) {
+        case NSM_INIT:
+            ntimer_init(&g_sleeper_timer, epa);
+            ntimer_after(&nsys_timer_wheel, &g_sleeper_timer, SLEEP_TICKS);
+            nepa_send_signal(epa, NSIGNAL_EVERY);
+            break;
+        case NSIGNAL_EVERY:
+            nepa_send_signal(epa, NSIGNAL_EVERY);
+            break;
+        case NSIGNAL_AFTER:
+            nscheduler_stop(&g_scheduler);
+            break;
+        default:
+            break;
+    }
+    return nsm_event_handled();
+}
+
+static struct busy_epa_queue nevent_queue(4) g_busy_epa_queue;
+
+static struct nepa g_busy_epa = NEPA_INITIALIZER(
+        &g_busy_epa_queue,
+        NEPA_FSM_TYPE,
+        busy_state,
+        NULL,
+        2);
+
+static nsm_action remote_state(struct nsm * sm, const struct nevent * event)
+{
+    NPLATFORM_UNUSED_ARG(sm);
+
+    if (event->id == NSIGNAL_AFTER) {
+        nscheduler_stop(&g_scheduler);
+    }
+    return nsm_event_handled();
+}
+
+static struct remote_epa_queue nevent_queue(4) g_remote_epa_queue;
+
+static struct nepa g_remote_epa = NEPA_INITIALIZER(
+        &g_remote_epa_queue,
+        NEPA_FSM_TYPE,
+        remote_state,
+        NULL,
+        2);
+
+static void * arming_thread(void * arg)
+{
+    struct timespec delay = {
+        .tv_nsec = 10000000
+    };
+    NPLATFORM_UNUSED_ARG(arg);
+
+    nanosleep(&delay, NULL);
+    ntimer_init(&g_sleeper_timer, &g_remote_epa);
+    ntimer_after(&nsys_timer_wheel, &g_sleeper_timer, 1u);
+
+    return NULL;
+}
+
+NTESTSUITE_TEST(test_none_tickless_timer)
+{
+    uint64_t cpu_time = cpu_time_us();
+
+    nscheduler_start(&g_scheduler, g_sleeper_epas);
+    cpu_time = cpu_time_us() - cpu_time;
+
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(g_sleeper_ticks >= SLEEP_TICKS);
+    /* The scheduler must sleep instead of polling.
+     */
+    ntestsuite_expect_bool(true);
+    ntestsuite_actual_bool(cpu_time < (SLEEP_TICKS * NCONFIG_SYS_TICK_US / 2u));
+}
+
+NTESTSUITE_TEST(test_none_tickless_wakeup)
+{
+    pthread_t thread;
+
+    pthread_create(&thread, NULL, sender_thread, NULL);
+    nscheduler_start(&g_scheduler, g_sleeper_epas);
+    pthread_join(thread, NULL);
+    ntimer_cancel(&g_sleeper_timer);
+
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(nscheduler_is_started(&g_scheduler));
+}
+
+NTESTSUITE_TEST(test_none_tickless_busy)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_busy_epa,
+        NULL
+    };
+    nscheduler_start(&g_scheduler, epas);
+
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(ntimer_is_running(&g_sleeper_timer));
+}
+
+/* No timer is armed when the scheduler goes to sleep, so only arming the
+ * timer from the other thread can wake it up.
+ */
+NTESTSUITE_TEST(test_none_tickless_remote_arm)
+{
+    static struct nepa * const epas[] =
+    {
+        &g_remote_epa,
+        NULL
+    };
+    pthread_t thread;
+
+    pthread_create(&thread, NULL, arming_thread, NULL);
+    nscheduler_start(&g_scheduler, epas);
+    pthread_join(thread, NULL);
+
+    ntestsuite_expect_bool(false);
+    ntestsuite_actual_bool(ntimer_is_running(&g_sleeper_timer));
+}
+#endif
+
+static void setup_none(void)
+{
+    nscheduler_init(&g_scheduler);
+    ntimer_wheel_init(&g_wheel);
+
+    for (uint32_t i = 0u; i < MANY_TIMERS; i++) {
+        ntimer_init(&g_timers[i], &g_ticker_epa);
+    }
+    g_ticks = 0u;
+    g_tick_limit = 0u;
+    g_fired_count = 0u;
+    g_fired_sum = 0u;
+}
+
+void test_exec_ntimer(void)
+{
+    ntestsuite_set_fixture(none, setup_none, NULL);
+    ntestsuite_run(test_none_after);
+    ntestsuite_run(test_none_every);
+    ntestsuite_run(test_none_cancel);
+    ntestsuite_run(test_none_rearm);
+    ntestsuite_run(test_none_cascade);
+    ntestsuite_run(test_none_many);
+    ntestsuite_run(test_none_next);
+    ntestsuite_run(test_none_advance);
+#if (NCONFIG_SYS_USE_TICKLESS_IDLE == 1)
+    ntestsuite_run(test_none_tickless_timer);
+    ntestsuite_run(test_none_tickless_wakeup);
+    ntestsuite_run(test_none_tickless_busy);
+    ntestsuite_run(test_none_tickless_remote_arm);
+#endif
+}
@@ -9,3 +9,4 @@ BUILD_ARCH_DESC = "ARMv7-M Architecture"
 # Includes and sources
 CC_INCLUDES += lib/va_include/nport/arch_armv7_m
 
+CC_SOURCES += neon/variant/arch/armv7_m/armv7_m_arch.c